@@ -175,6 +175,10 @@ PWM_point1 = 20.0 # (S) Point between segments 0 and 1. Used when n_pieces >= 2.
 PWM_point2 = 80.0  # (S) Point between segments 1 and 2. Used when n_pieces >= 3.
 PWM_point3 = 150.0  # (S) Point between segments 2 and 3. Used when n_pieces = 4.
 
+# Number of entries in the lookup table solution for ENABLE_SPINDLE_PWM_TABLE. The table is
+# interpolated directly from the measured data and does not use the piecewise line fit above.
+n_table = 33 # Integer (2-256). Entries are evenly spaced in rpm between min and max measured rpm.
+
 # ----------------------------------------------------------------------------------------
 
 # Advanced settings
@@ -340,6 +344,20 @@ else:
   print("\n[No cpu_map.h changes required.]")
 print("\n")
 
+# Lookup table solution. Invert the measured data by linear interpolation of the programmed PWM
+# at evenly spaced rpm values. Requires RPM_measured to be strictly ascending.
+if np.any(np.diff(RPM_measured) <= 0.0):
+  print("ERROR: RPM_measured must be strictly ascending to produce a lookup table solution.\n")
+else:
+  rpm_table = np.linspace(RPM_measured[0], RPM_measured[-1], n_table)
+  pwm_table = np.rint(np.interp(rpm_table, RPM_measured, PWM_set)).astype(int)
+  print("[Alternatively, update these #define values and uncomment]\n[ENABLE_SPINDLE_PWM_TABLE in config.h.]")
+  print("#define N_PWM_TABLE %i" % n_table)
+  print("#define RPM_TABLE_MAX %.1f" % rpm_table[-1])
+  print("#define RPM_TABLE_MIN %.1f" % rpm_table[0])
+  print("#define SPINDLE_PWM_TABLE { %s }" % ", ".join("%i" % v for v in pwm_table))
+  print("\n")
+
 test_val = (1./a[0])*rpm[0] - (b[0]/a[0])
 if test_val < 0.0 :
   print("ERROR: Solution is negative at RPM_MIN. Adjust junction points or increase n_pieces.\n")
@@ -11,15 +11,17 @@ response from the computer. This effectively adds another
 buffer layer to prevent buffer starvation.
 
 CHANGELOG:
+- 20261019: Serial read buffer size read from the '$I' build info.
+    Realtime commands may be sent at given lines. Per-line
+    send-to-response latency and lines/sec throughput stats.
+    The native client sim/stream.c (grbl_stream) streams the same
+    way, without the Python serial latency.
 - 20170531: Status report feedback at 1.0 second intervals.
     Configurable baudrate and report intervals. Bug fixes.
 - 20161212: Added push message feedback for simple streaming
 - 20140714: Updated baud rate to 115200. Added a settings
   write mode via simple streaming method. MIT-licensed.
 
-TODO: 
-- Add realtime control commands during streaming.
-
 ---------------------
 The MIT License (MIT)
 
@@ -52,7 +54,7 @@ import sys
 import argparse
 import threading
 
-RX_BUFFER_SIZE = 128
+RX_BUFFER_SIZE = 128 # Default, if not reported by '$I' build info.
 BAUD_RATE = 115200
 ENABLE_STATUS_REPORTS = True
 REPORT_INTERVAL = 1.0 # seconds
@@ -71,6 +73,14 @@ parser.add_argument('-s','--settings',action='store_true', default=False,
         help='settings write mode')        
 parser.add_argument('-c','--check',action='store_true', default=False,
         help='stream in check mode')
+parser.add_argument('-b','--rx-buffer',type=int, default=0,
+        help='grbl serial read buffer size. Read from $I build info, if not set')
+parser.add_argument('-i','--interval',type=float, default=REPORT_INTERVAL,
+        help='status report query interval in seconds. 0 disables')
+parser.add_argument('-r','--realtime',action='append', default=[], metavar='LINE:CMD',
+        help='send a realtime command after sending a line, as a character or hex code, e.g. 20:! or 50:0x91. Repeatable')
+parser.add_argument('-l','--latency-log',type=argparse.FileType('w'),
+        help='write per-line send-to-response latency in seconds to a csv file')
 args = parser.parse_args()
 
 # Periodic timer to query for status reports
@@ -81,7 +91,33 @@ def send_status_query():
 def periodic_timer() :
     while is_run:
       send_status_query()
-      time.sleep(REPORT_INTERVAL)
+      time.sleep(args.interval)
+
+# Reads grbl's serial read buffer size from the last field of the '$I' build option line.
+def read_rx_buffer_size():
+    s.write("$I\n")
+    rx_buffer_size = RX_BUFFER_SIZE
+    while 1:
+        grbl_out = s.readline().strip()
+        if grbl_out.startswith('[OPT:') :
+            rx_buffer_size = int(grbl_out.rstrip(']').split(',')[-1])
+        elif grbl_out.find('ok') >= 0 or grbl_out.find('error') >= 0 :
+            return rx_buffer_size
+
+# Parse realtime commands to send after the given line numbers.
+realtime_cmds = {}
+for rt in args.realtime :
+    rt_line, rt_cmd = rt.split(':',1)
+    if len(rt_cmd) > 1 : rt_cmd = chr(int(rt_cmd,16))
+    realtime_cmds.setdefault(int(rt_line),[]).append(rt_cmd)
+
+# Per-line send-to-response latency tracking
+send_time = {}
+latency = []
+def record_response(line_num, grbl_out):
+    t = time.time()-send_time.pop(line_num)
+    latency.append(t)
+    if args.latency_log : args.latency_log.write(str(line_num)+","+("%.6f" % t)+","+grbl_out+"\n")
   
 
 # Initialize
@@ -102,6 +138,10 @@ s.write("\r\n\r\n")
 time.sleep(2)
 s.flushInput()
 
+if args.rx_buffer > 0 : RX_BUFFER_SIZE = args.rx_buffer
+else : RX_BUFFER_SIZE = read_rx_buffer_size()
+if verbose: print "Grbl serial read buffer size:",RX_BUFFER_SIZE
+
 if check_mode :
     print "Enabling Grbl Check-Mode: SND: [$C]",
     s.write("$C\n")
@@ -118,7 +158,7 @@ if check_mode :
 start_time = time.time();
 
 # Start status report periodic timer
-if ENABLE_STATUS_REPORTS :
+if ENABLE_STATUS_REPORTS and args.interval > 0 :
     timerThread = threading.Thread(target=periodic_timer)
     timerThread.daemon = True
     timerThread.start()
@@ -135,13 +175,16 @@ if settings_mode:
         # l_block = re.sub('\s|\(.*?\)','',line).upper() # Strip comments/spaces/new line and capitalize
         l_block = line.strip() # Strip all EOL characters for consistency
         if verbose: print "SND>"+str(l_count)+": \"" + l_block + "\""
+        send_time[l_count] = time.time()
         s.write(l_block + '\n') # Send g-code block to grbl
         while 1:
             grbl_out = s.readline().strip() # Wait for grbl response with carriage return
             if grbl_out.find('ok') >= 0 :
+                record_response(l_count, grbl_out)
                 if verbose: print "  REC<"+str(l_count)+": \""+grbl_out+"\""
                 break
             elif grbl_out.find('error') >= 0 :
+                record_response(l_count, grbl_out)
                 if verbose: print "  REC<"+str(l_count)+": \""+grbl_out+"\""
                 error_count += 1
                 break
@@ -168,10 +211,16 @@ else:
             else :
                 if out_temp.find('error') >= 0 : error_count += 1
                 g_count += 1 # Iterate g-code counter
+                record_response(g_count, out_temp)
                 if verbose: print "  REC<"+str(g_count)+": \""+out_temp+"\""
                 del c_line[0] # Delete the block character count corresponding to the last 'ok'
+        send_time[l_count] = time.time()
         s.write(l_block + '\n') # Send g-code block to grbl
         if verbose: print "SND>"+str(l_count)+": \"" + l_block + "\""
+        # Send any realtime commands scheduled after this line. These bypass the serial read buffer.
+        for rt_cmd in realtime_cmds.get(l_count,[]) :
+            s.write(rt_cmd)
+            if verbose: print "SND> realtime: "+repr(rt_cmd)
     # Wait until all responses have been received.
     while l_count > g_count :
         out_temp = s.readline().strip() # Wait for grbl response
@@ -180,6 +229,7 @@ else:
         else :
             if out_temp.find('error') >= 0 : error_count += 1
             g_count += 1 # Iterate g-code counter
+            record_response(g_count, out_temp)
             del c_line[0] # Delete the block character count corresponding to the last 'ok'
             if verbose: print "  REC<"+str(g_count)+": \""+out_temp + "\""
 
@@ -187,7 +237,13 @@ else:
 print "\nG-code streaming finished!"
 end_time = time.time();
 is_run = False;
-print " Time elapsed: ",end_time-start_time,"\n"
+print " Time elapsed: ",end_time-start_time
+if l_count > 0 :
+    print " Throughput: ",l_count/(end_time-start_time),"lines/sec"
+    latency.sort()
+    print " Send-to-response latency: mean",sum(latency)/len(latency),"s, median",latency[len(latency)/2], \
+        "s, 99th percentile",latency[min(len(latency)-1,int(0.99*len(latency)))],"s, max",latency[-1],"s\n"
+if args.latency_log : args.latency_log.close()
 if check_mode :
     if error_count > 0 :
         print "CHECK FAILED:",error_count,"errors found! See output for details.\n"
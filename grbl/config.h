@@ -158,6 +158,60 @@
 // goes from 16 to 15 to make room for the additional line number data in the plan_block_t struct
 // #define USE_LINE_NUMBERS // Disabled by default. Uncomment to enable.
 
+// Enables a g-code parser fast path for simple linear motion blocks, such as `X1.2Y3.4` or
+// `G1X1.2Y3.4F300`, which make up most CAM programs. Blocks with only axis words, and optionally
+// a G0/G1 command and F and N words, in G94 mode, skip the full error-checking and state update
+// steps and are executed directly. Results are identical to the full parser path.
+// NOTE: Costs some flash. Helps most with short segment programs streamed at high feed rates.
+// #define ENABLE_PARSER_FAST_PATH // Default disabled. Uncomment to enable.
+
+// Enables the G73, G81, G82, and G83 canned drilling cycles, along with the G98 and G99 return modes,
+// as described by LinuxCNC. Each hole is expanded by Grbl into its rapid, feed, dwell, and peck
+// motions, so a drilling job is streamed as one short line per hole. The cycle axis is the one normal
+// to the selected plane, with the R, Q, and P words and the cycle axis depth retained by the blocks
+// of a canned cycle series, until another motion mode is selected. L repeats a cycle, spaced by the
+// hole offset in G91 incremental mode. G73 chip break retracts and G83 peck clearances are set below.
+// NOTE: Canned cycles are not supported in G93 inverse time mode.
+// #define ENABLE_CANNED_CYCLES // Default disabled. Uncomment to enable.
+// #define CANNED_CYCLE_PECK_RETRACT 0.254 // G73 retract and G83 clearance in mm. (Default 0.010 inch)
+
+// Enables LinuxCNC-style O-word subprograms, stored in EEPROM and replayed by Grbl without the serial
+// link. The g-code lines between 'O100 SUB' and 'O100 ENDSUB' are stored as subprogram 100, rather than
+// executed, and 'O100 CALL' executes them. The lines between 'O100 REPEAT [5]' and 'O100 ENDREPEAT' are
+// stored the same way and then executed five times. Stored lines may call other subprograms and hold
+// REPEAT blocks with their own numbers, up to SUBPROGRAM_MAX_DEPTH levels deep. Defining a subprogram
+// again replaces it, and '$RST=*' erases all.
+// NOTE: The store shares the free lower half of the Atmega328p EEPROM, which holds roughly 300 bytes of
+// g-code with four bytes of overhead per line. EEPROM writes are slow and wear the EEPROM, so define
+// repeated features once per job, rather than once per repeat.
+// #define ENABLE_SUBPROGRAMS // Default disabled. Uncomment to enable.
+// #define SUBPROGRAM_MAX_DEPTH 4 // Uncomment to override default in subprogram.h.
+
+// Enables local program storage, so a job runs at full speed from storage, rather than at the pace of
+// the serial link and host. '$FW=3' uploads the following g-code lines as program 3, until '$FC'.
+// '$FR=3' runs it, '$FR=3,120' resumes it from its line 120, '$FD=3' deletes it, and '$F' lists the
+// stored programs. While a program runs, the status report shows its number and current line, and
+// the lines per second it executes when the performance counters are also enabled. Programs are
+// kept in the EEPROM beyond the first 1KB, which requires an Atmega2560 or similar. The simulator
+// keeps them as files instead, see 'grbl_sim -p'. A resumed program first executes its lines before
+// the resume line in check mode, to restore their modal state, and then turns on their spindle and
+// coolant.
+// NOTE: Streamed g-code and all '$' commands but the reports are locked out while a stored program
+// runs. Realtime commands still work.
+// #define ENABLE_PROGRAM_STORAGE // Default disabled. Uncomment to enable.
+// #define STORAGE_EEPROM_PROGRAMS 3 // Uncomment to override default in storage.h.
+
+// Enables the '%' program delimiters. Between them, Grbl treats the streamed g-code as a program and
+// holds the auto-cycle start, until the planner buffer is primed with enough blocks or motion time,
+// rather than starting as soon as the host pauses streaming. This avoids starting a program, or
+// resuming it after a buffer sync, with a nearly empty planner that decelerates to a stop and
+// re-accelerates soon after. The cycle starts early at the closing '%', or on a timeout when the
+// host stops sending. Each '%' line starts or ends a program.
+// #define ENABLE_PROGRAM_MODE // Default disabled. Uncomment to enable.
+// #define PROGRAM_MODE_PRIME_BLOCKS 8 // Uncomment to override default in protocol.h.
+// #define PROGRAM_MODE_PRIME_TIME 1.0 // Uncomment to override default in protocol.h.
+// #define PROGRAM_MODE_TIMEOUT 500 // Uncomment to override default in protocol.h.
+
 // Upon a successful probe cycle, this option provides immediately feedback of the probe coordinates
 // through an automatically generated message. If disabled, users can still access the last probe
 // coordinates through Grbl '$#' print parameters.
@@ -179,6 +233,24 @@
 #define SAFETY_DOOR_SPINDLE_DELAY 4.0 // Float (seconds)
 #define SAFETY_DOOR_COOLANT_DELAY 1.0 // Float (seconds)
 
+// Waits for the spindle to reach its programmed speed, rather than using the fixed safety door spin-up
+// delay above or requiring G4 dwells after M3/M4 in programs. After a spindle start or speed change by
+// the g-code parser, safety door restore, or spindle stop override restore, Grbl blocks only until the
+// spindle is ready. By default, the wait time is modelled from the change in spindle rpm and the ramp
+// rate below, which should match the acceleration configured in the spindle drive. Spindle stops do
+// not wait. Ignored in laser mode, which doesn't require a spin-up.
+// #define ENABLE_SPINDLE_AT_SPEED_WAIT // Default disabled. Uncomment to enable.
+#define SPINDLE_RAMP_RATE 6000.0 // Float (rpm/sec). Used by the modelled spindle wait only.
+
+// With the spindle wait enabled, polls a spindle drive "at speed" or "speed reached" output on the
+// at-speed input pin, instead of modelling the ramp. Execution resumes the moment the drive reports
+// ready. If it doesn't within the timeout, Grbl halts with an alarm. The input is active low with the
+// internal pull-up resistor enabled, which suits open-collector drive outputs, unless inverted.
+// NOTE: Uses the coolant mist pin (Uno Analog Pin 4) and is not compatible with ENABLE_M7 or dual axis.
+// #define USE_SPINDLE_AT_SPEED_INPUT_PIN // Default disabled. Uncomment to enable.
+// #define INVERT_SPINDLE_AT_SPEED_PIN // Default disabled. Uncomment to enable.
+#define SPINDLE_AT_SPEED_TIMEOUT 10.0 // Float (seconds)
+
 // Enable CoreXY kinematics. Use ONLY with CoreXY machines.
 // IMPORTANT: If homing is enabled, you must reconfigure the homing cycle #defines above to
 // #define HOMING_CYCLE_0 (1<<X_AXIS) and #define HOMING_CYCLE_1 (1<<Y_AXIS)
@@ -235,6 +307,69 @@
 // Enables code for debugging purposes. Not for general use and always in constant flux.
 // #define DEBUG // Uncomment to enable. Default disabled.
 
+// Enables a compact status report mode, selected by '$10' status report mask value 8, for affordable
+// high-rate reporting over the serial TX buffer. Each report only contains the fields that changed
+// since the last report, and the position is sent as integer step deltas in machine coordinates with
+// the 'D:' field. A keyframe with all fields and the absolute machine position in steps, 'MS:', is
+// sent with every work coordinate offset refresh, which includes the first report after a reset.
+// Hosts convert steps to positions with the '$100'-'$102' steps/mm settings.
+// #define ENABLE_COMPACT_STATUS_REPORT // Default disabled. Uncomment to enable.
+
+// Enables push-based status reports, sent periodically without '?' real-time command polling. The '$33'
+// setting sets the report interval in milliseconds, where zero disables them. When '$10' status report
+// mask value 4 is set, auto reports are sent only when the machine state, position, override values,
+// or work coordinate offset have changed since the last auto report. The interval is timed by a tick
+// from the Timer2 compare B interrupt at the spindle PWM frequency, but reports are still written out
+// by the main program, like a '?' report.
+// NOTE: Requires a prescaled spindle PWM frequency. Not supported with the 62.5kHz option.
+// NOTE: Adds '$33' to the EEPROM settings under a new settings version, so the EEPROM data is restored to
+// defaults once after enabling or disabling this option.
+// #define ENABLE_AUTO_STATUS_REPORT // Default disabled. Uncomment to enable.
+#define AUTO_STATUS_REPORT_MIN_INTERVAL 20 // Integer (milliseconds). Minimum non-zero '$33' interval.
+#define DEFAULT_STATUS_REPORT_INTERVAL 0 // Integer (milliseconds). Default '$33' setting. Disabled.
+
+// Enables chunked report printing, so that the long '$$', '$#', and '$I' reports no longer block the
+// main program while waiting on the serial TX buffer. The main loop prints these reports one line at
+// a time, only when the TX buffer has room for a line, and holds off processing further commands
+// until the report and its 'ok' response are complete. Planning and segment generation continue to
+// run in the meantime, so '$$' and '$#' may be requested during a cycle. Real-time status reports are
+// printed a field at a time in the same way, and are completed before any other output.
+// NOTE: Lines longer than the chunk TX free space, like a long '$I' build info line, may still wait
+// briefly for the TX buffer.
+// #define ENABLE_CHUNKED_REPORTS // Default disabled. Uncomment to enable.
+// #define REPORT_CHUNK_TX_MIN_FREE 40 // Serial TX bytes free to print a report line. (1-TX_BUFFER_SIZE)
+// #define REPORT_STATUS_TX_MIN_FREE 48 // Serial TX bytes free to print a status report field. (1-TX_BUFFER_SIZE)
+
+// Enables on-controller performance counters, printed with the '$P' command and cleared with '$PR'.
+// Times the g-code parser, planner, segment preparation, arc generation, and status reports, along
+// with the waits for a free planner block, and counts serial RX overflows and segment buffer
+// underruns. Helps to tell whether a slow job is bound by parsing, planning, or serial throughput.
+// Times are measured with the spindle timer, at a 4usec resolution with the default 1/64 prescaler.
+// NOTE: Adds a spindle timer overflow interrupt, about once per millisecond. Not compatible with
+// spindle PWM dithering or the 62.5kHz spindle PWM.
+// #define ENABLE_PERF_COUNTERS // Default disabled. Uncomment to enable.
+
+// Enables an execution time estimate in '$C' check g-code mode. Rather than being discarded, motions
+// are planned by the planner and prepped into step segments, which are then executed on a virtual
+// clock with the stepper ISR step timing, instead of by the steppers. Acceleration limits, buffer
+// syncs, dwells, and the active feed and rapid overrides are all accounted for. The total estimated
+// time in seconds is reported as '[EST:time]' at program end (M2/M30) and upon exiting check mode.
+// With line numbers enabled, the motion time of each line is also reported as '[EST:Nline,time]',
+// when its motion is complete.
+// The 'grbl_estimate' tool of the /sim folder runs the same estimate of a g-code file on a host.
+// NOTE: Estimates are for a planner buffer kept full by the host. Spindle and coolant delays, as
+// well as feed holds, are not included.
+// #define ENABLE_CHECK_MODE_ESTIMATE // Default disabled. Uncomment to enable.
+
+// Enables an executed-motion trace for post-mortem analysis of stutters and lost positions. The
+// stepper ISR records each completed step segment in a RAM ring buffer, with a timestamp, its stepper
+// block index, step events, step rate, AMASS level, and line number, if enabled. The '$T' command
+// dumps the records, oldest first, in a compact hex form for a host to log. The trace is kept
+// through a soft-reset, but not a power cycle. Requires ENABLE_PERF_COUNTERS for the timestamps.
+// NOTE: Each record takes 10 bytes of RAM, or 14 bytes with line numbers enabled.
+// #define ENABLE_MOTION_TRACE // Default disabled. Uncomment to enable.
+// #define MOTION_TRACE_SIZE 16 // Number of trace records. (1-255)
+
 // Configure rapid, feed, and spindle override settings. These values define the max and min
 // allowable override values and the coarse and fine increments per command received. Please
 // note the allowable values in the descriptions following each define.
@@ -396,6 +531,36 @@
 // bogged down by too many trig calculations.
 #define N_ARC_CORRECTION 12 // Integer (1-255)
 
+// Generates the arc segments with a fixed-point vector rotation instead of the small angle approximation
+// above. The rotation is computed once per arc and applied with 32-bit integer multiplies, with a
+// rounding error that is bounded well below step resolution, so the periodic sin() and cos() corrections
+// of N_ARC_CORRECTION are not needed. The last segment still ends exactly at the arc target.
+// #define ENABLE_FIXED_POINT_ARCS // Default disabled. Uncomment to enable.
+
+// Plans the segments of an arc lazily. Rather than waiting in mc_arc() until the planner has room for
+// every segment, an arc plans only the segments that fit and the main loop plans the rest as planner
+// blocks become free. The arc line is acknowledged right away, so the host keeps streaming and the
+// following lines are read and parsed while the arc executes. The rest of the arc is planned before
+// any following motion or buffer sync, so motions still execute in program order.
+// #define ENABLE_LAZY_ARCS // Default disabled. Uncomment to enable.
+
+// Chooses the arc segment length from both the arc tolerance ($12) and the feed rate and acceleration
+// of the arc, for fewer segments on slower arcs. Grbl's default segments have their end points on the
+// arc, and their junction speed limits how fast an arc can run. An arc that is slower anyway, by its
+// feed rate or max rates, may use longer segments with the same speed. These segments place their end
+// points just outside the arc, so that they deviate from it by up to the arc tolerance on either side,
+// for up to ~1.4x longer segments. Fewer planner blocks per arc let the planner buffer cover more motion.
+// #define ENABLE_ADAPTIVE_ARC_SEGMENTS // Default disabled. Uncomment to enable.
+
+// Enables the G5 cubic and G5.1 quadratic spline motions in the G17 XY plane, as described by LinuxCNC.
+// A spline is planned as line segments by an adaptive subdivision of the curve, with each segment within
+// the arc tolerance ($12) of it, so segments are long where the curve is flat and short where it bends.
+// A G5 without I and J continues the last G5 smoothly. For freeform surfaces, one spline line replaces
+// many short G1 lines, for shorter programs and less streaming. With ENABLE_LAZY_ARCS, the segments
+// of a spline are planned lazily, as they are for arcs.
+// #define ENABLE_SPLINES // Default disabled. Uncomment to enable.
+// #define SPLINE_MIN_STEP (1.0/16384) // Uncomment to override default in motion_control.h.
+
 // The arc G2/3 g-code standard is problematic by definition. Radius-based arcs have horrible numerical
 // errors when arc at semi-circles(pi) or full-circles(2*pi). Offset-based arcs are much more accurate
 // but still have a problem when arcs are full-circles (2*pi). This define accounts for the floating
@@ -586,6 +751,26 @@
 // to ensure the laser doesn't inadvertently remain powered while at a stop and cause a fire.
 #define DISABLE_LASER_DURING_HOLD // Default enabled. Comment to disable.
 
+// In laser M4 dynamic power mode, the laser PWM is computed once per step segment, so the power only
+// updates every 1/ACCELERATION_TICKS_PER_SECOND seconds and changes in visible steps while accelerating.
+// This option ramps the PWM output linearly from the last segment value to the new segment value
+// within the stepper ISR, spread by Bresenham over the segment step events. Segments with fewer step
+// events than PWM counts to ramp advance the PWM by several counts per step. Since a segment runs at
+// a constant step rate, this follows the velocity ramp in time. Only rate-adjusted M4 laser motions
+// are affected. Adds a small counter update to every stepper ISR tick during these motions.
+// #define ENABLE_LASER_PWM_INTERPOLATION // Default disabled. Uncomment to enable.
+
+// Enables the laser raster scanline command '$L'. A scanline is sent as a pixel pitch vector, an
+// optional feed rate, and a run of hex-packed 8-bit power values, i.e. '$LX0.1F3000=00FF7F..'.
+// The run is planned as a single line motion from the current position and each pixel scales the
+// programmed S-value laser power, as the stepper ISR crosses the pixel boundaries. Consecutive
+// scanlines in the same direction join at full speed, so a raster image no longer streams as one
+// G1 block per pixel. Requires laser mode ($32=1) and variable spindle.
+// NOTE: Pixels are buffered in a separate ring buffer of RASTER_BUFFER_SIZE bytes, which must be
+// large enough to hold at least one full scanline command. Uses roughly 1KB of flash.
+// #define ENABLE_LASER_RASTER // Default disabled. Uncomment to enable.
+// #define RASTER_BUFFER_SIZE 128 // Uncomment to override default in raster.h.
+
 // This feature alters the spindle PWM/speed to a nonlinear output with a simple piecewise linear
 // curve. Useful for spindles that don't produce the right RPM from Grbl's standard spindle PWM 
 // linear model. Requires a solution by the 'fit_nonlinear_spindle.py' script in the /doc/script
@@ -612,6 +797,33 @@
 #define RPM_LINE_A4  1.203413e-01  // Used N_PIECES = 4. A and B constants of line 4.
 #define RPM_LINE_B4  1.151360e+03
 
+// Increases the variable spindle PWM resolution beyond the 8-bit Timer2 register for fine laser power
+// control, such as greyscale engraving. Spindle PWM values are computed and passed to the stepper ISR
+// with SPINDLE_PWM_DITHER_BITS of extra fractional resolution, which are then output by dithering the
+// PWM register between adjacent values each PWM period with a Timer2 overflow interrupt. The average
+// output power over 2^SPINDLE_PWM_DITHER_BITS PWM periods resolves the fractional value.
+// NOTE: The 328p has no free 16-bit timer, as Timer1 drives the stepper ISR. The dithering interrupt only
+// runs when the output has a fractional part, but costs roughly 40 CPU cycles each PWM period when it
+// does. Do not use with the un-prescaled 62.5kHz PWM frequency. Best suited to a 1.96kHz or 7.8kHz PWM.
+// #define ENABLE_SPINDLE_PWM_DITHERING // Default disabled. Uncomment to enable.
+#define SPINDLE_PWM_DITHER_BITS 4 // Integer (1-8). Extra bits of PWM resolution. 4 gives a 12-bit output.
+
+// This feature alters the spindle PWM/speed to a nonlinear output with a lookup table of PWM values,
+// evenly spaced in RPM between RPM_TABLE_MIN and RPM_TABLE_MAX. PWM values are linearly interpolated
+// between table entries with integer math, which is faster than the piecewise linear model and can
+// follow a highly nonlinear spindle or laser response much more closely. Requires a solution by the
+// 'fit_nonlinear_spindle.py' script in the /doc/script folder. Do not enable with the piecewise model.
+// #define ENABLE_SPINDLE_PWM_TABLE  // Default disabled. Uncomment to enable.
+
+// N_PWM_TABLE, RPM_TABLE_MAX, RPM_TABLE_MIN, and SPINDLE_PWM_TABLE are all set and given by the
+// 'fit_nonlinear_spindle.py' script solution. Used only when ENABLE_SPINDLE_PWM_TABLE is enabled.
+// NOTE: Table values must be ascending. The table is stored in flash and uses N_PWM_TABLE bytes.
+#define N_PWM_TABLE 33  // Integer (2-256). Number of table entries.
+#define RPM_TABLE_MAX  11650.0  // Max RPM of table. $30 > RPM_TABLE_MAX will be limited to RPM_TABLE_MAX.
+#define RPM_TABLE_MIN  213.0    // Min RPM of table. $31 < RPM_TABLE_MIN will be limited to RPM_TABLE_MIN.
+#define SPINDLE_PWM_TABLE { 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 13, 14, 15, 16, 17, 20, 23, 27, 31, 35, \
+                            40, 46, 52, 58, 65, 73, 83, 96, 114, 134, 167, 205, 254 }
+
 /* --------------------------------------------------------------------------------------- 
   This optional dual axis feature is primarily for the homing cycle to locate two sides of 
   a dual-motor gantry independently, i.e. self-squaring. This requires an additional limit
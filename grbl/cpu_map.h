@@ -106,6 +106,12 @@
     #define COOLANT_MIST_PORT  PORTC
     #define COOLANT_MIST_BIT   4  // Uno Analog Pin 4
 
+    // Define spindle at-speed input pin. Shares the coolant mist pin, when M7 is not enabled.
+    #define SPINDLE_AT_SPEED_DDR   DDRC
+    #define SPINDLE_AT_SPEED_PIN   PINC
+    #define SPINDLE_AT_SPEED_PORT  PORTC
+    #define SPINDLE_AT_SPEED_BIT   4  // Uno Analog Pin 4
+
     // Define spindle enable and spindle direction output pins.
     #define SPINDLE_ENABLE_DDR    DDRB
     #define SPINDLE_ENABLE_PORT   PORTB
@@ -138,6 +144,14 @@
     #define SPINDLE_TCCRB_REGISTER    TCCR2B
     #define SPINDLE_OCR_REGISTER      OCR2A
     #define SPINDLE_COMB_BIT          COM2A1
+    #define SPINDLE_TIMSK_REGISTER    TIMSK2
+    #define SPINDLE_TOIE_BIT          TOIE2 // Overflow interrupt used by PWM dithering or perf counters.
+    #define SPINDLE_TCNT_REGISTER     TCNT2
+    #define SPINDLE_TIFR_REGISTER     TIFR2
+    #define SPINDLE_TOV_BIT           TOV2
+    #define SPINDLE_TIMER_OVF_vect    TIMER2_OVF_vect
+    #define SPINDLE_OCIEB_BIT         OCIE2B // Compare B interrupt used only by auto status reports.
+    #define SPINDLE_TIMER_COMPB_vect  TIMER2_COMPB_vect
 
     // Prescaled, 8-bit Fast PWM mode.
     #define SPINDLE_TCCRA_INIT_MASK   ((1<<WGM20) | (1<<WGM21))  // Configures fast PWM mode.
@@ -202,6 +216,14 @@
       #define SPINDLE_TCCRB_REGISTER    TCCR2B
       #define SPINDLE_OCR_REGISTER      OCR2A
       #define SPINDLE_COMB_BIT          COM2A1
+      #define SPINDLE_TIMSK_REGISTER    TIMSK2
+      #define SPINDLE_TOIE_BIT          TOIE2 // Overflow interrupt used by PWM dithering or perf counters.
+      #define SPINDLE_TCNT_REGISTER     TCNT2
+      #define SPINDLE_TIFR_REGISTER     TIFR2
+      #define SPINDLE_TOV_BIT           TOV2
+      #define SPINDLE_TIMER_OVF_vect    TIMER2_OVF_vect
+      #define SPINDLE_OCIEB_BIT         OCIE2B // Compare B interrupt used only by auto status reports.
+      #define SPINDLE_TIMER_COMPB_vect  TIMER2_COMPB_vect
 
       // Prescaled, 8-bit Fast PWM mode.
       #define SPINDLE_TCCRA_INIT_MASK   ((1<<WGM20) | (1<<WGM21))  // Configures fast PWM mode.
@@ -32,6 +32,14 @@
 #define AXIS_COMMAND_MOTION_MODE 2
 #define AXIS_COMMAND_TOOL_LENGTH_OFFSET 3 // *Undefined but required
 
+// Value words that can't be negative. The G5 P word is a signed control point offset, so a negative P
+// word is checked for the commands that use it as a dwell time or index instead, in STEP 3.
+#ifdef ENABLE_SPLINES
+  #define GC_UNSIGNED_WORDS (bit(WORD_F)|bit(WORD_N)|bit(WORD_T)|bit(WORD_S))
+#else
+  #define GC_UNSIGNED_WORDS (bit(WORD_F)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S))
+#endif
+
 // Declare gc extern struct
 parser_state_t gc_state;
 parser_block_t gc_block;
@@ -111,6 +119,9 @@ uint8_t gc_execute_line(char *line)
   float value;
   uint8_t int_value = 0;
   uint16_t mantissa = 0;
+  #ifdef ENABLE_CANNED_CYCLES
+    uint8_t l_status = STATUS_OK; // Canned cycle L error, found before its uint8 conversion.
+  #endif
   if (gc_parser_flags & GC_PARSER_JOG_MOTION) { char_counter = 3; } // Start parsing after `$J=`
   else { char_counter = 0; }
 
@@ -160,6 +171,12 @@ uint8_t gc_execute_line(char *line)
               mantissa = 0; // Set to zero to indicate valid non-integer G command.
             }                
             break;
+          #ifdef ENABLE_CANNED_CYCLES
+            case 73: case 81: case 82: case 83:
+          #endif
+          #ifdef ENABLE_SPLINES
+            case 5:
+          #endif
           case 0: case 1: case 2: case 3: case 38:
             // Check for G0/1/2/3/38 being called with G10/28/30/92 on same block.
             // * G43.1 is also an axis command but is not explicitly defined this way.
@@ -176,6 +193,12 @@ uint8_t gc_execute_line(char *line)
               gc_block.modal.motion += (mantissa/10)+100;
               mantissa = 0; // Set to zero to indicate valid non-integer G command.
             }  
+            #ifdef ENABLE_SPLINES
+              if ((int_value == 5) && (mantissa == 10)) {
+                gc_block.modal.motion = MOTION_MODE_QUADRATIC_SPLINE; // G5.1
+                mantissa = 0; // Set to zero to indicate valid non-integer G command.
+              }
+            #endif
             break;
           case 17: case 18: case 19:
             word_bit = MODAL_GROUP_G2;
@@ -225,6 +248,12 @@ uint8_t gc_execute_line(char *line)
             word_bit = MODAL_GROUP_G12;
             gc_block.modal.coord_select = int_value - 54; // Shift to array indexing.
             break;
+          #ifdef ENABLE_CANNED_CYCLES
+            case 98: case 99:
+              word_bit = MODAL_GROUP_G10;
+              gc_block.modal.retract = int_value - 98;
+              break;
+          #endif
           case 61:
             word_bit = MODAL_GROUP_G13;
             if (mantissa != 0) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G61.1 not supported]
@@ -305,11 +334,21 @@ uint8_t gc_execute_line(char *line)
           case 'I': word_bit = WORD_I; gc_block.values.ijk[X_AXIS] = value; ijk_words |= (1<<X_AXIS); break;
           case 'J': word_bit = WORD_J; gc_block.values.ijk[Y_AXIS] = value; ijk_words |= (1<<Y_AXIS); break;
           case 'K': word_bit = WORD_K; gc_block.values.ijk[Z_AXIS] = value; ijk_words |= (1<<Z_AXIS); break;
-          case 'L': word_bit = WORD_L; gc_block.values.l = int_value; break;
+          case 'L': word_bit = WORD_L; gc_block.values.l = int_value;
+            #ifdef ENABLE_CANNED_CYCLES
+              // The uint8 conversion wraps L. Keep its error for the canned cycle repeats, as G10 reports
+              // any L other than L2 and L20 as unsupported.
+              if (value < 0.0) { l_status = STATUS_NEGATIVE_VALUE; }
+              else if (value != trunc(value)) { l_status = STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER; }
+              else if (value > 255.0) { l_status = STATUS_GCODE_MAX_VALUE_EXCEEDED; }
+            #endif
+            break;
           case 'N': word_bit = WORD_N; gc_block.values.n = trunc(value); break;
           case 'P': word_bit = WORD_P; gc_block.values.p = value; break;
           // NOTE: For certain commands, P value must be an integer, but none of these commands are supported.
-          // case 'Q': // Not supported
+          #if defined(ENABLE_CANNED_CYCLES) || defined(ENABLE_SPLINES)
+            case 'Q': word_bit = WORD_Q; gc_block.values.q = value; break;
+          #endif
           case 'R': word_bit = WORD_R; gc_block.values.r = value; break;
           case 'S': word_bit = WORD_S; gc_block.values.s = value; break;
           case 'T': word_bit = WORD_T; 
@@ -326,7 +365,7 @@ uint8_t gc_execute_line(char *line)
         if (bit_istrue(value_words,bit(word_bit))) { FAIL(STATUS_GCODE_WORD_REPEATED); } // [Word repeated]
         // Check for invalid negative values for words F, N, P, T, and S.
         // NOTE: Negative value check is done here simply for code-efficiency.
-        if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S)) ) {
+        if ( bit(word_bit) & GC_UNSIGNED_WORDS ) {
           if (value < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Word value cannot be negative]
         }
         value_words |= bit(word_bit); // Flag to indicate parameter assigned.
@@ -335,6 +374,68 @@ uint8_t gc_execute_line(char *line)
   }
   // Parsing complete!
 
+  #ifdef ENABLE_PARSER_FAST_PATH
+    /* -------------------------------------------------------------------------------------
+       FAST PATH: Most CAM program lines are simple linear motions, like `X1.2Y3.4` or `G1X1.2F300`.
+       When a block has axis words and only G0/G1, F, and N words besides them, in G94 mode, the
+       target is computed and the motion executed directly, skipping the STEP 3 and STEP 4 checks
+       and state updates that can't apply. The same operations are performed in the same order as
+       in the full path, so the results are identical. Blocks that don't qualify, or would error,
+       continue through the full path below. */
+    if ( axis_words && bit_isfalse(gc_parser_flags,GC_PARSER_JOG_MOTION) &&
+         !(command_words & ~bit(MODAL_GROUP_G1)) &&
+         !(value_words & ~(bit(WORD_F)|bit(WORD_N)|bit(WORD_X)|bit(WORD_Y)|bit(WORD_Z))) &&
+         ((gc_block.modal.motion == MOTION_MODE_SEEK) || (gc_block.modal.motion == MOTION_MODE_LINEAR)) &&
+         (gc_state.modal.feed_rate == FEED_RATE_MODE_UNITS_PER_MIN) && (gc_block.values.n <= MAX_LINE_NUMBER) ) {
+
+      // Resolve the feed rate first, since an undefined G1 feed rate is left for the full path to report.
+      float feed_rate = gc_state.feed_rate;
+      if (bit_istrue(value_words,bit(WORD_F))) {
+        feed_rate = gc_block.values.f;
+        if (gc_block.modal.units == UNITS_MODE_INCHES) { feed_rate *= MM_PER_INCH; }
+      }
+      if ((gc_block.modal.motion == MOTION_MODE_SEEK) || (feed_rate != 0.0)) {
+
+        // Compute the target in the active coordinate system and distance mode. See STEP 3 [12.] and [19.]
+        uint8_t idx;
+        for (idx=0; idx<N_AXIS; idx++) {
+          if (bit_isfalse(axis_words,bit(idx))) {
+            gc_block.values.xyz[idx] = gc_state.position[idx];
+          } else {
+            if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.values.xyz[idx] *= MM_PER_INCH; }
+            if (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE) {
+              gc_block.values.xyz[idx] += gc_state.coord_system[idx] + gc_state.coord_offset[idx];
+              if (idx == TOOL_LENGTH_OFFSET_AXIS) { gc_block.values.xyz[idx] += gc_state.tool_length_offset; }
+            } else {
+              gc_block.values.xyz[idx] += gc_state.position[idx];
+            }
+          }
+        }
+
+        // Update the few states a simple motion block changes and execute it. See STEP 4.
+        plan_line_data_t plan_data;
+        memset(&plan_data,0,sizeof(plan_line_data_t));
+        gc_state.line_number = gc_block.values.n;
+        #ifdef USE_LINE_NUMBERS
+          plan_data.line_number = gc_state.line_number;
+        #endif
+        gc_state.feed_rate = feed_rate;
+        plan_data.feed_rate = feed_rate;
+        // NOTE: Laser mode passes zero spindle speed for G0 motions. The speed itself is unchanged.
+        if (bit_isfalse(settings.flags,BITFLAG_LASER_MODE) || (gc_block.modal.motion == MOTION_MODE_LINEAR)) {
+          plan_data.spindle_speed = gc_state.spindle_speed;
+        }
+        gc_state.tool = gc_block.values.t; // Tracks the (zeroed) tool value, as the full path does.
+        plan_data.condition = (gc_state.modal.spindle | gc_state.modal.coolant);
+        gc_state.modal.motion = gc_block.modal.motion;
+        if (gc_state.modal.motion == MOTION_MODE_SEEK) { plan_data.condition |= PL_COND_FLAG_RAPID_MOTION; }
+        mc_line(gc_block.values.xyz, &plan_data);
+        memcpy(gc_state.position, gc_block.values.xyz, sizeof(gc_block.values.xyz));
+        return(STATUS_OK);
+      }
+    }
+  #endif
+
 
   /* -------------------------------------------------------------------------------------
      STEP 3: Error-check all commands and values passed in this block. This step ensures all of
@@ -370,6 +471,15 @@ uint8_t gc_execute_line(char *line)
     if (!axis_command) { axis_command = AXIS_COMMAND_MOTION_MODE; } // Assign implicit motion-mode
   }
 
+  #ifdef ENABLE_SPLINES
+    // Check for a negative P value, unless it's the control point offset of a G5 spline motion.
+    if (bit_istrue(value_words,bit(WORD_P)) && (gc_block.values.p < 0.0)) {
+      if ((gc_block.modal.motion != MOTION_MODE_CUBIC_SPLINE) || (axis_command != AXIS_COMMAND_MOTION_MODE)) {
+        FAIL(STATUS_NEGATIVE_VALUE); // [Word value cannot be negative]
+      }
+    }
+  #endif
+
   // Check for valid line number N value.
   if (bit_istrue(value_words,bit(WORD_N))) {
     // Line number value cannot be less than zero (done) or greater than max line number.
@@ -512,7 +622,36 @@ uint8_t gc_execute_line(char *line)
 
   // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
   // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
-  // [18. Set retract mode ]: NOT SUPPORTED.
+  // [18. Set retract mode ]: G98 and G99 canned cycle return modes only.
+  // NOTE: Canned cycle R, Q, and P words and the cycle axis word, the hole bottom, are sticky within a
+  // series of canned cycles. Update them with the words of this block, before the cycle axis word is
+  // converted to a target in [19.]. Errors are checked and the retract plane computed in [20.].
+  #ifdef ENABLE_CANNED_CYCLES
+    gc_canned_t canned;
+    if (gc_is_canned_cycle(gc_block.modal.motion)) {
+      if (gc_is_canned_cycle(gc_state.modal.motion)) {
+        memcpy(&canned,&gc_state.canned,sizeof(gc_canned_t));
+      } else { // Start a new series.
+        canned.words = 0;
+        canned.initial_level = gc_state.position[axis_linear];
+      }
+      if ((axis_command == AXIS_COMMAND_MOTION_MODE) && bit_istrue(axis_words,bit(axis_linear))) {
+        canned.z = gc_block.values.xyz[axis_linear];
+        canned.words |= bit(WORD_Z);
+      }
+      if (gc_block.modal.units == UNITS_MODE_INCHES) {
+        gc_block.values.r *= MM_PER_INCH;
+        gc_block.values.q *= MM_PER_INCH;
+      }
+      if (bit_istrue(value_words,bit(WORD_R))) { canned.r = gc_block.values.r; }
+      if (bit_istrue(value_words,bit(WORD_Q))) {
+        if (gc_block.values.q < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Peck depth cannot be negative]
+        canned.q = gc_block.values.q;
+      }
+      if (bit_istrue(value_words,bit(WORD_P))) { canned.p = gc_block.values.p; }
+      canned.words |= (value_words & (bit(WORD_R)|bit(WORD_Q)|bit(WORD_P)));
+    }
+  #endif
 
   // [19. Remaining non-modal actions ]: Check go to predefined position, set G10, or set axis offsets.
   // NOTE: We need to separate the non-modal commands that are axis word-using (G10/G28/G30/G92), as these
@@ -818,6 +957,87 @@ uint8_t gc_execute_line(char *line)
           if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
           if (isequal_position_vector(gc_state.position, gc_block.values.xyz)) { FAIL(STATUS_GCODE_INVALID_TARGET); } // [Invalid target]
           break;
+        #ifdef ENABLE_SPLINES
+          case MOTION_MODE_CUBIC_SPLINE: case MOTION_MODE_QUADRATIC_SPLINE:
+            // [G5/G5.1 Errors]: Feed rate undefined. No axis words. Plane is not G17. Z axis word.
+            // [G5 Errors]: P or Q word missing. Only one of I and J. I and J missing, unless the last
+            //   motion was a G5. [G5.1 Errors]: I and J both missing.
+            // NOTE: I,J is the offset from the current position to the first control point and P,Q the
+            // offset from the target to the second one. A G5.1 quadratic spline is converted to these
+            // offsets of the same curve as a cubic, with the control points 2/3 of the way from each end
+            // point to the G5.1 control point at I,J.
+            if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
+            if ((gc_block.modal.plane_select != PLANE_SELECT_XY) || (axis_words & bit(Z_AXIS))) {
+              FAIL(STATUS_GCODE_SPLINE_PLANE); // [Not in XY plane]
+            }
+            if (gc_block.modal.units == UNITS_MODE_INCHES) {
+              gc_block.values.ijk[X_AXIS] *= MM_PER_INCH;
+              gc_block.values.ijk[Y_AXIS] *= MM_PER_INCH;
+              gc_block.values.p *= MM_PER_INCH;
+              gc_block.values.q *= MM_PER_INCH;
+            }
+            if (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE) {
+              if ((value_words & (bit(WORD_P)|bit(WORD_Q))) != (bit(WORD_P)|bit(WORD_Q))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [P/Q word missing]
+              if (ijk_words & (bit(X_AXIS)|bit(Y_AXIS))) {
+                if ((ijk_words & (bit(X_AXIS)|bit(Y_AXIS))) != (bit(X_AXIS)|bit(Y_AXIS))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [I/J word missing]
+              } else {
+                if (gc_state.modal.motion != MOTION_MODE_CUBIC_SPLINE) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [I/J word missing]
+                gc_block.values.ijk[X_AXIS] = -gc_state.spline_offset[X_AXIS];
+                gc_block.values.ijk[Y_AXIS] = -gc_state.spline_offset[Y_AXIS];
+              }
+              bit_false(value_words,(bit(WORD_P)|bit(WORD_Q)));
+            } else {
+              if (!(ijk_words & (bit(X_AXIS)|bit(Y_AXIS)))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [I/J word missing]
+              gc_block.values.p = (2.0/3.0)*(gc_state.position[X_AXIS]+gc_block.values.ijk[X_AXIS]-gc_block.values.xyz[X_AXIS]);
+              gc_block.values.q = (2.0/3.0)*(gc_state.position[Y_AXIS]+gc_block.values.ijk[Y_AXIS]-gc_block.values.xyz[Y_AXIS]);
+              gc_block.values.ijk[X_AXIS] *= (2.0/3.0);
+              gc_block.values.ijk[Y_AXIS] *= (2.0/3.0);
+            }
+            bit_false(value_words,(bit(WORD_I)|bit(WORD_J)));
+            break;
+        #endif
+        #ifdef ENABLE_CANNED_CYCLES
+          case MOTION_MODE_DRILL_CHIP_BREAK: case MOTION_MODE_DRILL:
+          case MOTION_MODE_DRILL_DWELL: case MOTION_MODE_DRILL_PECK:
+            // [G73/G81-83 Errors]: Feed rate undefined. Inverse time mode. Cycle axis word or R word not
+            //   programmed in the series. G82 P word or G73/G83 positive Q word not programmed in the series.
+            //   L not positive. Retract plane below the hole bottom.
+            // Axis words are optional. If missing, set axis command flag to ignore execution.
+            if (gc_block.modal.feed_rate == FEED_RATE_MODE_INVERSE_TIME) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G93 not supported]
+            if (!axis_words) { axis_command = AXIS_COMMAND_NONE; break; }
+            if ((canned.words & (bit(WORD_Z)|bit(WORD_R))) != (bit(WORD_Z)|bit(WORD_R))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [Z/R word missing]
+            bit_false(value_words,bit(WORD_R));
+            if (gc_block.modal.motion == MOTION_MODE_DRILL_DWELL) {
+              if (bit_isfalse(canned.words,bit(WORD_P))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [P word missing]
+              bit_false(value_words,bit(WORD_P));
+            } else if (gc_block.modal.motion != MOTION_MODE_DRILL) {
+              if (bit_isfalse(canned.words,bit(WORD_Q)) || (canned.q == 0.0)) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [Q word missing]
+              bit_false(value_words,bit(WORD_Q));
+            }
+            if (bit_istrue(value_words,bit(WORD_L))) {
+              if (l_status != STATUS_OK) { FAIL(l_status); } // [L negative, not an integer or above 255]
+              if (gc_block.values.l == 0) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [L not positive]
+              bit_false(value_words,bit(WORD_L));
+            } else {
+              gc_block.values.l = 1;
+            }
+            gc_block.values.q = canned.q;
+            gc_block.values.p = canned.p;
+
+            // Compute the retract plane and hole bottom. In incremental mode, R is relative to the cycle
+            // axis position and the bottom to the retract plane. Otherwise, both are in work coordinates.
+            if (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE) {
+              float cycle_offset = block_coord_system[axis_linear] + gc_state.coord_offset[axis_linear];
+              if (axis_linear == TOOL_LENGTH_OFFSET_AXIS) { cycle_offset += gc_state.tool_length_offset; }
+              gc_block.values.r = canned.r + cycle_offset;
+              gc_block.values.xyz[axis_linear] = canned.z + cycle_offset;
+            } else {
+              gc_block.values.r = gc_state.position[axis_linear] + canned.r;
+              gc_block.values.xyz[axis_linear] = gc_block.values.r + canned.z;
+            }
+            if (gc_block.values.xyz[axis_linear] > gc_block.values.r) { FAIL(STATUS_GCODE_INVALID_TARGET); } // [R below bottom]
+            break;
+        #endif
       }
     }
   }
@@ -868,7 +1088,7 @@ uint8_t gc_execute_line(char *line)
   // If in laser mode, setup laser power based on current and past parser conditions.
   if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) {
     if ( !((gc_block.modal.motion == MOTION_MODE_LINEAR) || (gc_block.modal.motion == MOTION_MODE_CW_ARC) 
-        || (gc_block.modal.motion == MOTION_MODE_CCW_ARC)) ) {
+        || (gc_block.modal.motion == MOTION_MODE_CCW_ARC) || gc_is_spline(gc_block.modal.motion)) ) {
       gc_parser_flags |= GC_PARSER_LASER_DISABLE;
     }
 
@@ -882,7 +1102,7 @@ uint8_t gc_execute_line(char *line)
       // a G1/2/3 motion mode state and vice versa when there is no motion in the line.
       if (gc_state.modal.spindle == SPINDLE_ENABLE_CW) {
         if ((gc_state.modal.motion == MOTION_MODE_LINEAR) || (gc_state.modal.motion == MOTION_MODE_CW_ARC) 
-            || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
+            || (gc_state.modal.motion == MOTION_MODE_CCW_ARC) || gc_is_spline(gc_state.modal.motion)) {
           if (bit_istrue(gc_parser_flags,GC_PARSER_LASER_DISABLE)) { 
             gc_parser_flags |= GC_PARSER_LASER_FORCE_SYNC; // Change from G1/2/3 motion mode.
           }
@@ -1005,7 +1225,10 @@ uint8_t gc_execute_line(char *line)
   // [17. Set distance mode ]:
   gc_state.modal.distance = gc_block.modal.distance;
 
-  // [18. Set retract mode ]: NOT SUPPORTED
+  // [18. Set retract mode ]: G98 and G99 canned cycle return modes only.
+  #ifdef ENABLE_CANNED_CYCLES
+    gc_state.modal.retract = gc_block.modal.retract;
+  #endif
 
   // [19. Go to predefined position, Set G10, or Set axis offsets ]:
   switch(gc_block.non_modal_command) {
@@ -1046,6 +1269,9 @@ uint8_t gc_execute_line(char *line)
   // NOTE: Commands G10,G28,G30,G92 lock out and prevent axis words from use in motion modes.
   // Enter motion modes only if there are axis words or a motion mode command word in the block.
   gc_state.modal.motion = gc_block.modal.motion;
+  #ifdef ENABLE_CANNED_CYCLES
+    if (gc_is_canned_cycle(gc_state.modal.motion)) { memcpy(&gc_state.canned,&canned,sizeof(gc_canned_t)); }
+  #endif
   if (gc_state.modal.motion != MOTION_MODE_NONE) {
     if (axis_command == AXIS_COMMAND_MOTION_MODE) {
       uint8_t gc_update_pos = GC_UPDATE_POS_TARGET;
@@ -1055,8 +1281,41 @@ uint8_t gc_execute_line(char *line)
         pl_data->condition |= PL_COND_FLAG_RAPID_MOTION; // Set rapid motion condition flag.
         mc_line(gc_block.values.xyz, pl_data);
       } else if ((gc_state.modal.motion == MOTION_MODE_CW_ARC) || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
+        #ifdef ENABLE_PERF_COUNTERS
+          uint32_t perf_start = perf_get_ticks();
+        #endif
         mc_arc(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk, gc_block.values.r,
             axis_0, axis_1, axis_linear, bit_istrue(gc_parser_flags,GC_PARSER_ARC_IS_CLOCKWISE));
+        #ifdef ENABLE_PERF_COUNTERS
+          perf_record(PERF_TIMER_MC_ARC,perf_start);
+        #endif
+      #ifdef ENABLE_SPLINES
+      } else if (gc_is_spline(gc_state.modal.motion)) {
+        mc_spline(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk,
+            gc_block.values.p, gc_block.values.q);
+        gc_state.spline_offset[X_AXIS] = gc_block.values.p;
+        gc_state.spline_offset[Y_AXIS] = gc_block.values.q;
+      #endif
+      #ifdef ENABLE_CANNED_CYCLES
+      } else if (gc_is_canned_cycle(gc_state.modal.motion)) {
+        // Drill the hole L times. In incremental mode, the repeats are spaced by the hole offset.
+        // NOTE: mc_canned_cycle() updates gc_state.position with the final retract position.
+        float clear_level = gc_block.values.r;
+        if (gc_state.modal.retract == RETRACT_MODE_INITIAL_LEVEL) { clear_level = max(clear_level,canned.initial_level); }
+        float hole_offset[N_AXIS];
+        for (idx=0; idx<N_AXIS; idx++) {
+          if ((gc_state.modal.distance == DISTANCE_MODE_INCREMENTAL) && (idx != axis_linear)) {
+            hole_offset[idx] = gc_block.values.xyz[idx]-gc_state.position[idx];
+          } else { hole_offset[idx] = 0.0; }
+        }
+        while (1) {
+          mc_canned_cycle(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.r, clear_level,
+              gc_block.values.q, gc_block.values.p, axis_linear, gc_state.modal.motion);
+          if ((--gc_block.values.l == 0) || sys.abort) { break; }
+          for (idx=0; idx<N_AXIS; idx++) { gc_block.values.xyz[idx] += hole_offset[idx]; }
+        }
+        gc_update_pos = GC_UPDATE_POS_NONE;
+      #endif
       } else {
         // NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
         // upon a successful probing cycle, the machine position and the returned value should be the same.
@@ -1122,12 +1381,18 @@ uint8_t gc_execute_line(char *line)
         spindle_set_state(SPINDLE_DISABLE,0.0);
         coolant_set_state(COOLANT_DISABLE);
       }
+      #ifdef ENABLE_CHECK_MODE_ESTIMATE
+        else {
+          report_estimate_total(st_estimate_get_time()); // Report and restart for the next program.
+          st_estimate_reset();
+        }
+      #endif
       report_feedback_message(MESSAGE_PROGRAM_END);
     }
     gc_state.modal.program_flow = PROGRAM_FLOW_RUNNING; // Reset program flow.
   }
 
-  // TODO: % to denote start of program.
+  // NOTE: The '%' program delimiters are handled by the protocol, with ENABLE_PROGRAM_MODE.
 
   return(STATUS_OK);
 }
@@ -1136,7 +1401,7 @@ uint8_t gc_execute_line(char *line)
 /*
   Not supported:
 
-  - Canned cycles
+  - Canned cycles, other than G73 and G81-G83 with ENABLE_CANNED_CYCLES
   - Tool radius compensation
   - A,B,C-axes
   - Evaluation of expressions
@@ -1147,13 +1412,13 @@ uint8_t gc_execute_line(char *line)
 
    (*) Indicates optional parameter, enabled through config.h and re-compile
    group 0 = {G92.2, G92.3} (Non modal: Cancel and re-enable G92 offsets)
-   group 1 = {G81 - G89} (Motion modes: Canned cycles)
+   group 1 = {G84 - G89} (Motion modes: Canned cycles. G73, G81-G83 are supported*)
    group 4 = {M1} (Optional stop, ignored)
    group 6 = {M6} (Tool change)
    group 7 = {G41, G42} cutter radius compensation (G40 is supported)
    group 8 = {G43} tool length offset (G43.1/G49 are supported)
    group 8 = {M7*} enable mist coolant (* Compile-option)
    group 9 = {M48, M49, M56*} enable/disable override switches (* Compile-option)
-   group 10 = {G98, G99} return mode canned cycles
+   group 10 = {G98*, G99*} return mode canned cycles
    group 13 = {G61.1, G64} path control mode (G61 is supported)
 */
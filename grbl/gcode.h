@@ -30,7 +30,7 @@
 // and are similar/identical to other g-code interpreters by manufacturers (Haas,Fanuc,Mazak,etc).
 // NOTE: Modal group define values must be sequential and starting from zero.
 #define MODAL_GROUP_G0 0 // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G5,G5.1,G38.2,G38.3,G38.4,G38.5,G73,G80,G81,G82,G83] Motion
 #define MODAL_GROUP_G2 2 // [G17,G18,G19] Plane selection
 #define MODAL_GROUP_G3 3 // [G90,G91] Distance mode
 #define MODAL_GROUP_G4 4 // [G91.1] Arc IJK distance mode
@@ -46,6 +46,8 @@
 #define MODAL_GROUP_M8 13 // [M7,M8,M9] Coolant control
 #define MODAL_GROUP_M9 14 // [M56] Override control
 
+#define MODAL_GROUP_G10 15 // [G98,G99] Canned cycle return mode
+
 // Define command actions for within execution-type modal groups (motion, stopping, non-modal). Used
 // internally by the parser to know which command to execute.
 // NOTE: Some macro values are assigned specific values to make g-code state reporting and parsing 
@@ -70,11 +72,24 @@
 #define MOTION_MODE_LINEAR 1 // G1 (Do not alter value)
 #define MOTION_MODE_CW_ARC 2  // G2 (Do not alter value)
 #define MOTION_MODE_CCW_ARC 3  // G3 (Do not alter value)
+#define MOTION_MODE_CUBIC_SPLINE 5 // G5 (Do not alter value)
+#define MOTION_MODE_QUADRATIC_SPLINE 15 // G5.1 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD 140 // G38.2 (Do not alter value)
 #define MOTION_MODE_PROBE_TOWARD_NO_ERROR 141 // G38.3 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY 142 // G38.4 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY_NO_ERROR 143 // G38.5 (Do not alter value)
 #define MOTION_MODE_NONE 80 // G80 (Do not alter value)
+#define MOTION_MODE_DRILL_CHIP_BREAK 73 // G73 (Do not alter value)
+#define MOTION_MODE_DRILL 81 // G81 (Do not alter value)
+#define MOTION_MODE_DRILL_DWELL 82 // G82 (Do not alter value)
+#define MOTION_MODE_DRILL_PECK 83 // G83 (Do not alter value)
+
+// Checks if a motion mode is one of the G73 and G81-G83 canned drilling cycles.
+#define gc_is_canned_cycle(motion) (((motion) == MOTION_MODE_DRILL_CHIP_BREAK) || \
+  (((motion) >= MOTION_MODE_DRILL) && ((motion) <= MOTION_MODE_DRILL_PECK)))
+
+// Checks if a motion mode is one of the G5 and G5.1 splines.
+#define gc_is_spline(motion) (((motion) == MOTION_MODE_CUBIC_SPLINE) || ((motion) == MOTION_MODE_QUADRATIC_SPLINE))
 
 // Modal Group G2: Plane select
 #define PLANE_SELECT_XY 0 // G17 (Default: Must be zero)
@@ -135,6 +150,10 @@
 // Modal Group G12: Active work coordinate system
 // N/A: Stores coordinate system value (54-59) to change to.
 
+// Modal Group G10: Canned cycle return mode
+#define RETRACT_MODE_INITIAL_LEVEL 0 // G98 (Default: Must be zero)
+#define RETRACT_MODE_R_LEVEL 1 // G99 (Do not alter value)
+
 // Define parameter word mapping.
 #define WORD_F  0
 #define WORD_I  1
@@ -149,6 +168,7 @@
 #define WORD_X  10
 #define WORD_Y  11
 #define WORD_Z  12
+#define WORD_Q  13
 
 // Define g-code parser position updating flags
 #define GC_UPDATE_POS_TARGET   0 // Must be zero
@@ -194,6 +214,9 @@ typedef struct {
   uint8_t coolant;         // {M7,M8,M9}
   uint8_t spindle;         // {M3,M4,M5}
   uint8_t override;        // {M56}
+  #ifdef ENABLE_CANNED_CYCLES
+    uint8_t retract;       // {G98,G99}
+  #endif
 } gc_modal_t;
 
 typedef struct {
@@ -202,7 +225,9 @@ typedef struct {
   uint8_t l;       // G10 or canned cycles parameters
   int32_t n;       // Line number
   float p;         // G10 or dwell parameters
-  // float q;      // G82 peck drilling
+  #if defined(ENABLE_CANNED_CYCLES) || defined(ENABLE_SPLINES)
+    float q;       // G73/G83 peck depth or G5 control point offset
+  #endif
   float r;         // Arc radius
   float s;         // Spindle speed
   uint8_t t;       // Tool selection
@@ -210,6 +235,19 @@ typedef struct {
 } gc_values_t;
 
 
+#ifdef ENABLE_CANNED_CYCLES
+  // Sticky canned cycle words. Retained by the blocks of a series of canned cycles, from the first
+  // G73/G81-G83 block until another motion mode is selected.
+  typedef struct {
+    uint16_t words;        // Tracks the programmed sticky words. Uses the value word bits, with Z as the cycle axis.
+    float z;               // Hole bottom, as programmed on the cycle axis in mm
+    float r;               // Retract plane, as programmed in mm
+    float q;               // G73/G83 peck depth in mm
+    float p;               // G82 dwell time in seconds
+    float initial_level;   // Cycle axis machine position before the series. G98 retract level.
+  } gc_canned_t;
+#endif
+
 typedef struct {
   gc_modal_t modal;
 
@@ -225,6 +263,13 @@ typedef struct {
   float coord_offset[N_AXIS];    // Retains the G92 coordinate offset (work coordinates) relative to
                                  // machine zero in mm. Non-persistent. Cleared upon reset and boot.
   float tool_length_offset;      // Tracks tool length offset value when enabled.
+  #ifdef ENABLE_CANNED_CYCLES
+    gc_canned_t canned;          // Sticky words of the active canned cycle series
+  #endif
+  #ifdef ENABLE_SPLINES
+    float spline_offset[2];      // P and Q offsets of the last G5 in mm. Reflected by a following G5
+                                 // without I and J, for a smooth join.
+  #endif
 } parser_state_t;
 extern parser_state_t gc_state;
 
@@ -60,6 +60,10 @@
 #include "spindle_control.h"
 #include "stepper.h"
 #include "jog.h"
+#include "raster.h"
+#include "subprogram.h"
+#include "storage.h"
+#include "perf.h"
 
 // ---------------------------------------------------------------------------------------
 // COMPILE-TIME ERROR CHECKING OF DEFINE VALUES:
@@ -98,6 +102,74 @@
   #endif
 #endif
 
+#if defined(ENABLE_LASER_PWM_INTERPOLATION) && !defined(VARIABLE_SPINDLE)
+  #error "ENABLE_LASER_PWM_INTERPOLATION requires VARIABLE_SPINDLE enabled."
+#endif
+
+#if defined(ENABLE_LASER_RASTER)
+  #if !defined(VARIABLE_SPINDLE)
+    #error "ENABLE_LASER_RASTER requires VARIABLE_SPINDLE enabled."
+  #endif
+  #if (RASTER_BUFFER_SIZE < 2) || (RASTER_BUFFER_SIZE > 255)
+    #error "RASTER_BUFFER_SIZE must be within (2-255)."
+  #endif
+#endif
+
+#if defined(ENABLE_AUTO_STATUS_REPORT) && defined(VARIABLE_SPINDLE)
+  #if ((SPINDLE_TCCRB_INIT_MASK & 0x07) == (1<<CS20))
+    #error "ENABLE_AUTO_STATUS_REPORT not supported with the un-prescaled 62.5kHz spindle PWM."
+  #endif
+#endif
+
+#if defined(ENABLE_PERF_COUNTERS)
+  #if defined(ENABLE_SPINDLE_PWM_DITHERING)
+    #error "ENABLE_PERF_COUNTERS and ENABLE_SPINDLE_PWM_DITHERING both use the spindle timer overflow interrupt."
+  #endif
+  #if defined(VARIABLE_SPINDLE) && ((SPINDLE_TCCRB_INIT_MASK & 0x07) == (1<<CS20))
+    #error "ENABLE_PERF_COUNTERS not supported with the un-prescaled 62.5kHz spindle PWM."
+  #endif
+#endif
+
+#if defined(ENABLE_MOTION_TRACE)
+  #if !defined(ENABLE_PERF_COUNTERS)
+    #error "ENABLE_MOTION_TRACE requires ENABLE_PERF_COUNTERS for its timestamps."
+  #endif
+  #if (MOTION_TRACE_SIZE < 1) || (MOTION_TRACE_SIZE > 255)
+    #error "MOTION_TRACE_SIZE must be within (1-255)."
+  #endif
+#endif
+
+#if defined(USE_SPINDLE_AT_SPEED_INPUT_PIN)
+  #if !defined(ENABLE_SPINDLE_AT_SPEED_WAIT)
+    #error "USE_SPINDLE_AT_SPEED_INPUT_PIN requires ENABLE_SPINDLE_AT_SPEED_WAIT to be enabled."
+  #endif
+  #if defined(ENABLE_M7) || defined(ENABLE_DUAL_AXIS)
+    #error "USE_SPINDLE_AT_SPEED_INPUT_PIN not supported with ENABLE_M7 or dual axis feature."
+  #endif
+#elif defined(ENABLE_SPINDLE_AT_SPEED_WAIT)
+  #if !defined(VARIABLE_SPINDLE)
+    #error "Modelled ENABLE_SPINDLE_AT_SPEED_WAIT requires VARIABLE_SPINDLE. Use the at-speed input pin instead."
+  #endif
+#endif
+
+#if defined(ENABLE_SPINDLE_PWM_DITHERING)
+  #if !defined(VARIABLE_SPINDLE)
+    #error "ENABLE_SPINDLE_PWM_DITHERING requires VARIABLE_SPINDLE to be enabled."
+  #endif
+  #if (SPINDLE_PWM_DITHER_BITS < 1) || (SPINDLE_PWM_DITHER_BITS > 8)
+    #error "SPINDLE_PWM_DITHER_BITS must be within (1-8)."
+  #endif
+#endif
+
+#if defined(ENABLE_SPINDLE_PWM_TABLE)
+  #if defined(ENABLE_PIECEWISE_LINEAR_SPINDLE)
+    #error "ENABLE_SPINDLE_PWM_TABLE and ENABLE_PIECEWISE_LINEAR_SPINDLE can't be enabled together."
+  #endif
+  #if (N_PWM_TABLE < 2) || (N_PWM_TABLE > 256)
+    #error "N_PWM_TABLE must be within (2-256)."
+  #endif
+#endif
+
 #if (REPORT_WCO_REFRESH_BUSY_COUNT < REPORT_WCO_REFRESH_IDLE_COUNT)
   #error "WCO busy refresh is less than idle refresh."
 #endif
@@ -135,6 +207,12 @@
   #endif
 #endif
 
+#if defined(ENABLE_PROGRAM_STORAGE) && defined(__AVR__)
+  #if (E2END+1 <= STORAGE_EEPROM_ADDR)
+    #error "Program storage requires a processor with more EEPROM than Grbl uses, such as the Atmega2560."
+  #endif
+#endif
+
 // ---------------------------------------------------------------------------------------
 
 #endif
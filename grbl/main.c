@@ -43,6 +43,9 @@ int main(void)
   settings_init(); // Load Grbl settings from EEPROM
   stepper_init();  // Configure stepper pins and interrupt timers
   system_init();   // Configure pinout pins and pin-change interrupt
+  #ifdef ENABLE_PERF_COUNTERS
+    perf_init();   // Start performance counter time base
+  #endif
 
   memset(sys_position,0,sizeof(sys_position)); // Clear machine position.
   sei(); // Enable interrupts
@@ -88,11 +91,29 @@ int main(void)
     serial_reset_read_buffer(); // Clear serial read buffer
     gc_init(); // Set g-code parser to default state
     spindle_init();
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      report_auto_init(); // Must follow spindle_init(), which configures the report timer.
+    #endif
     coolant_init();
     limits_init();
     probe_init();
     plan_reset(); // Clear block buffer and planner variables
     st_reset(); // Clear stepper subsystem variables.
+    #ifdef ENABLE_LAZY_ARCS
+      mc_arc_reset(); // Discard the rest of a pending arc.
+    #endif
+    #ifdef ENABLE_LASER_RASTER
+      raster_reset(); // Clear raster pixel buffer.
+    #endif
+    #ifdef ENABLE_SUBPROGRAMS
+      subprogram_reset(); // Abandon any unfinished subprogram definition.
+    #endif
+    #ifdef ENABLE_PROGRAM_STORAGE
+      storage_reset(); // Stop a running stored program.
+    #endif
+    #ifdef ENABLE_CHUNKED_REPORTS
+      report_chunked_reset(); // Abandon any report interrupted by a reset.
+    #endif
 
     // Sync cleared gcode and planner positions to current system position.
     plan_sync_position();
@@ -21,6 +21,65 @@
 
 #include "grbl.h"
 
+// Define arc generator states.
+#define ARC_STATE_IDLE 0
+#define ARC_STATE_PENDING 1    // Segments remain to be planned
+#define ARC_STATE_GENERATING 2 // Segments are being planned
+
+// Arc segment generator variables. Keeps the arc between its segments, so that its segments may be
+// planned at any time after mc_arc() returns.
+typedef struct {
+  plan_line_data_t pl_data; // Planner data of all segments
+  float target[N_AXIS];     // Arc target, where the final segment ends
+  float position[N_AXIS];   // End of the last planned segment
+  float center_axis0;
+  float center_axis1;
+  float linear_per_segment;
+  #ifdef ENABLE_FIXED_POINT_ARCS
+    int32_t sin_T;          // Rotation coefficients sin(phi) and 1-cos(phi), as mantissa/2^shift
+    int32_t vers_T;
+    int8_t sin_shift;
+    int8_t vers_shift;
+    int32_t q_axis0;        // Q29 radius vector
+    int32_t q_axis1;
+    float mm_per_unit;
+  #else
+    float cos_T;            // Small angle approximation of the rotation matrix
+    float sin_T;
+    float r_axis0;          // Radius vector from center to the last segment end
+    float r_axis1;
+    float offset_axis0;     // Offset from the arc start to the center, for the arc correction
+    float offset_axis1;
+    float theta_per_segment;
+    uint8_t count;          // Segments since the last arc correction
+  #endif
+  uint16_t segment;         // Segments planned so far
+  uint16_t segments;        // Segments of the arc, including the final segment to the target
+  uint8_t axis_0;
+  uint8_t axis_1;
+  uint8_t axis_linear;
+  uint8_t state;
+} arc_t;
+static arc_t arc;
+
+#ifdef ENABLE_SPLINES
+  // Spline segment generator variables. Uses the arc generator states, so that a spline is planned
+  // lazily in the same way as an arc.
+  typedef struct {
+    plan_line_data_t pl_data; // Planner data of all segments
+    float target[N_AXIS];     // Spline target, where the final segment ends
+    float position[N_AXIS];   // End of the last planned segment
+    float a[2];               // XY polynomial coefficients of the curve ((a*t+b)*t+c)*t+d, 0 <= t <= 1
+    float b[2];
+    float c[2];
+    float d[2];
+    float t;                  // Curve parameter at the end of the last planned segment
+    float dt;                 // Curve parameter step of the last planned segment
+    uint8_t state;
+  } spline_t;
+  static spline_t spline;
+#endif
+
 
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
@@ -31,6 +90,10 @@
 // in the planner and to let backlash compensation or canned cycle integration simple and direct.
 void mc_line(float *target, plan_line_data_t *pl_data)
 {
+  #ifdef ENABLE_LAZY_ARCS
+    mc_arc_flush(); // Plan the rest of a pending arc or spline, before this motion.
+  #endif
+
   // If enabled, check for soft limit violations. Placed here all line motions are picked up
   // from everywhere in Grbl.
   if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
@@ -39,7 +102,15 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   }
 
   // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
-  if (sys.state == STATE_CHECK_MODE) { return; }
+  if (sys.state == STATE_CHECK_MODE) {
+    #ifdef ENABLE_CHECK_MODE_ESTIMATE
+      // Plan the motion for the estimator, which executes it on a virtual clock instead.
+      if (plan_check_full_buffer()) { st_estimate_execute(false); }
+      if (sys.abort) { return; } // Bail, if system abort.
+      plan_buffer_line(target, pl_data);
+    #endif
+    return;
+  }
 
   // NOTE: Backlash compensation may be installed here. It will need direction info to track when
   // to insert a backlash line motion(s) before the intended line motion and will require its own
@@ -57,6 +128,10 @@ void mc_line(float *target, plan_line_data_t *pl_data)
 
   // If the buffer is full: good! That means we are well ahead of the robot.
   // Remain in this loop until there is room in the buffer.
+  #ifdef ENABLE_PERF_COUNTERS
+    uint32_t perf_start = perf_get_ticks();
+    uint8_t planner_full = plan_check_full_buffer();
+  #endif
   do {
     protocol_execute_realtime(); // Check for any run-time commands
     if (sys.abort) { return; } // Bail, if system abort.
@@ -65,7 +140,15 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   } while (1);
 
   // Plan and queue motion into planner buffer
-  if (plan_buffer_line(target, pl_data) == PLAN_EMPTY_BLOCK) {
+  #ifdef ENABLE_PERF_COUNTERS
+    if (planner_full) { perf_record(PERF_TIMER_PLANNER_FULL,perf_start); }
+    perf_start = perf_get_ticks();
+  #endif
+  uint8_t plan_status = plan_buffer_line(target, pl_data);
+  #ifdef ENABLE_PERF_COUNTERS
+    perf_record(PERF_TIMER_PLAN_BUFFER,perf_start);
+  #endif
+  if (plan_status == PLAN_EMPTY_BLOCK) {
     if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) {
       // Correctly set spindle state, if there is a coincident position passed. Forces a buffer
       // sync while in M3 laser mode only.
@@ -77,6 +160,204 @@ void mc_line(float *target, plan_line_data_t *pl_data)
 }
 
 
+#ifdef ENABLE_FIXED_POINT_ARCS
+  // Splits a rotation coefficient into a signed ARC_FIXED_MANTISSA-bit mantissa and a shift, so that
+  // value = mantissa/2^shift.
+  static void mc_arc_coefficient(float value, int32_t *mantissa, int8_t *shift)
+  {
+    int exponent;
+    float fraction = frexp(value, &exponent); // value = fraction*2^exponent, 0.5 <= |fraction| < 1
+    *mantissa = lround(ldexp(fraction, ARC_FIXED_MANTISSA));
+    if (labs(*mantissa) == ((int32_t)1 << ARC_FIXED_MANTISSA)) { // Fraction rounded up to 1.
+      *mantissa /= 2;
+      exponent++;
+    }
+    *shift = ARC_FIXED_MANTISSA-exponent;
+  }
+
+
+  // Returns the rounded product of a Q29 radius vector component and a rotation coefficient. Uses
+  // three 16x16-bit multiplies with 32-bit products, rather than 64-bit multiplies. The omitted
+  // product of both low halves adds less than 1/65536 unit.
+  static int32_t mc_arc_product(int32_t q, int32_t mantissa, int8_t shift)
+  {
+    int16_t q_high = q >> 16;
+    uint16_t q_low = q;
+    int16_t m_high = mantissa >> 16;
+    uint16_t m_low = mantissa;
+    int32_t product = (int32_t)q_high*m_high +
+                      (((int32_t)q_high*m_low + (int32_t)q_low*m_high + 0x8000) >> 16); // q*mantissa/2^32
+    shift -= 32;
+    if (shift <= 0) { return(product*((int32_t)1 << -shift)); } // Only coefficients above 1/8
+    if (shift >= 31) { return(0); }
+    return((product + ((int32_t)1 << (shift-1))) >> shift);
+  }
+#endif
+
+
+// Plans the next segments of the arc. With ENABLE_LAZY_ARCS and unless told to wait, stops when the
+// planner buffer is full, leaving the arc pending until blocks are free again. Otherwise, waits for
+// free blocks in mc_line(), as usual.
+static void mc_arc_generate(uint8_t wait)
+{
+  arc.state = ARC_STATE_GENERATING; // Planning the arc segments mustn't flush the arc.
+  while (arc.segment < arc.segments) {
+    #ifdef ENABLE_LAZY_ARCS
+      if (!wait && plan_check_full_buffer()) {
+        protocol_auto_cycle_start(); // Auto-cycle start when buffer is full, as in mc_line().
+        arc.state = ARC_STATE_PENDING;
+        return;
+      }
+    #endif
+    arc.segment++;
+    if (arc.segment == arc.segments) {
+      // Ensure last segment arrives at target location.
+      mc_line(arc.target, &arc.pl_data);
+    } else {
+      #ifdef ENABLE_FIXED_POINT_ARCS
+        // Apply vector rotation matrix, as r_T = r - [1-cos(phi) sin(phi); -sin(phi) 1-cos(phi)] * r
+        int32_t q_axisi = arc.q_axis1 - (mc_arc_product(arc.q_axis1,arc.vers_T,arc.vers_shift) -
+                                         mc_arc_product(arc.q_axis0,arc.sin_T,arc.sin_shift));
+        arc.q_axis0 -= mc_arc_product(arc.q_axis0,arc.vers_T,arc.vers_shift) +
+                       mc_arc_product(arc.q_axis1,arc.sin_T,arc.sin_shift);
+        arc.q_axis1 = q_axisi;
+
+        // Update arc_target location
+        arc.position[arc.axis_0] = arc.center_axis0 + arc.q_axis0*arc.mm_per_unit;
+        arc.position[arc.axis_1] = arc.center_axis1 + arc.q_axis1*arc.mm_per_unit;
+      #else
+        if (arc.count < N_ARC_CORRECTION) {
+          // Apply vector rotation matrix. ~40 usec
+          float r_axisi = arc.r_axis0*arc.sin_T + arc.r_axis1*arc.cos_T;
+          arc.r_axis0 = arc.r_axis0*arc.cos_T - arc.r_axis1*arc.sin_T;
+          arc.r_axis1 = r_axisi;
+          arc.count++;
+        } else {
+          // Arc correction to radius vector. Computed only every N_ARC_CORRECTION increments. ~375 usec
+          // Compute exact location by applying transformation matrix from initial radius vector(=-offset).
+          float cos_Ti = cos(arc.segment*arc.theta_per_segment);
+          float sin_Ti = sin(arc.segment*arc.theta_per_segment);
+          arc.r_axis0 = -arc.offset_axis0*cos_Ti + arc.offset_axis1*sin_Ti;
+          arc.r_axis1 = -arc.offset_axis0*sin_Ti - arc.offset_axis1*cos_Ti;
+          arc.count = 0;
+        }
+
+        // Update arc_target location
+        arc.position[arc.axis_0] = arc.center_axis0 + arc.r_axis0;
+        arc.position[arc.axis_1] = arc.center_axis1 + arc.r_axis1;
+      #endif
+      arc.position[arc.axis_linear] += arc.linear_per_segment;
+
+      mc_line(arc.position, &arc.pl_data);
+    }
+
+    // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
+    if (sys.abort) { break; }
+  }
+  arc.state = ARC_STATE_IDLE;
+}
+
+
+#ifdef ENABLE_SPLINES
+  // Returns the deviation of the curve from a segment of it, from the last segment end at t to t+dt,
+  // with the segment end point in end. The deviation is scaled, so that a segment within the arc
+  // tolerance returns up to 1.0. This part of the curve is a cubic Bezier curve with the inner control
+  // points at dt/3 times its derivatives from the end points. With u = 3*p1-2*p0-p3 and v = 3*p2-p0-2*p3
+  // of its control points p0-p3, it is at most a distance of sqrt(max(ux^2,vx^2)+max(uy^2,vy^2))/4 from
+  // the segment, at the same curve parameter. The square of this bound is returned.
+  static float mc_spline_segment(float dt, float *end)
+  {
+    float t = spline.t+dt;
+    float error = 0.0;
+    uint8_t idx;
+    for (idx=0; idx<2; idx++) {
+      float start_slope = (3.0*spline.a[idx]*spline.t + 2.0*spline.b[idx])*spline.t + spline.c[idx];
+      float end_slope = (3.0*spline.a[idx]*t + 2.0*spline.b[idx])*t + spline.c[idx];
+      end[idx] = ((spline.a[idx]*t + spline.b[idx])*t + spline.c[idx])*t + spline.d[idx];
+      float u = spline.position[idx] + dt*start_slope - end[idx];
+      float v = end[idx] - dt*end_slope - spline.position[idx];
+      error += max(u*u, v*v);
+    }
+    return(error/(16.0*settings.arc_tolerance*settings.arc_tolerance));
+  }
+
+
+  // Plans the next segments of the spline. The deviation of a segment from a smooth curve grows with
+  // the square of its curve parameter step, so the step of each segment is predicted from the deviation
+  // of the last one, and reduced the same way until the segment is within the arc tolerance. Segments
+  // are long along flat parts of the curve and short where it bends. Waits for free planner blocks as
+  // mc_arc_generate() does.
+  static void mc_spline_generate(uint8_t wait)
+  {
+    spline.state = ARC_STATE_GENERATING; // Planning the spline segments mustn't flush the spline.
+    while (spline.t < 1.0) {
+      #ifdef ENABLE_LAZY_ARCS
+        if (!wait && plan_check_full_buffer()) {
+          protocol_auto_cycle_start(); // Auto-cycle start when buffer is full, as in mc_line().
+          spline.state = ARC_STATE_PENDING;
+          return;
+        }
+      #endif
+      float remaining = 1.0-spline.t;
+      float dt = spline.dt;
+      if (dt >= remaining) { dt = remaining; }
+      else if (2.0*dt > remaining) { dt = 0.5*remaining; } // Split the rest evenly, without a short last segment.
+      float end[2];
+      float deviation;
+      while (((deviation = mc_spline_segment(dt, end)) > 1.0) && (dt > SPLINE_MIN_STEP)) {
+        dt *= SPLINE_STEP_MARGIN*sqrt(sqrt(1.0/deviation));
+      }
+      // Predict the next step, growing up to twice this one.
+      if (deviation > 0.0625) { spline.dt = SPLINE_STEP_MARGIN*dt*sqrt(sqrt(1.0/deviation)); }
+      else { spline.dt = 2.0*dt; }
+      if (dt == remaining) {
+        // Ensure last segment arrives at target location.
+        spline.t = 1.0;
+        mc_line(spline.target, &spline.pl_data);
+      } else {
+        spline.t += dt;
+        spline.position[X_AXIS] = end[X_AXIS];
+        spline.position[Y_AXIS] = end[Y_AXIS];
+        mc_line(spline.position, &spline.pl_data);
+      }
+
+      // Bail mid-spline on system abort. Runtime command check already performed by mc_line.
+      if (sys.abort) { break; }
+    }
+    spline.state = ARC_STATE_IDLE;
+  }
+#endif
+
+
+#ifdef ENABLE_LAZY_ARCS
+  void mc_arc_continue()
+  {
+    if (arc.state == ARC_STATE_PENDING) { mc_arc_generate(false); }
+    #ifdef ENABLE_SPLINES
+      if (spline.state == ARC_STATE_PENDING) { mc_spline_generate(false); }
+    #endif
+  }
+
+
+  void mc_arc_flush()
+  {
+    if (arc.state == ARC_STATE_PENDING) { mc_arc_generate(true); }
+    #ifdef ENABLE_SPLINES
+      if (spline.state == ARC_STATE_PENDING) { mc_spline_generate(true); }
+    #endif
+  }
+
+
+  void mc_arc_reset()
+  {
+    arc.state = ARC_STATE_IDLE;
+    #ifdef ENABLE_SPLINES
+      spline.state = ARC_STATE_IDLE;
+    #endif
+  }
+#endif
+
+
 // Execute an arc in offset mode format. position == current xyz, target == target xyz,
 // offset == offset from current xyz, axis_X defines circle plane in tool space, axis_linear is
 // the direction of helical travel, radius == circle radius, isclockwise boolean. Used
@@ -84,9 +365,14 @@ void mc_line(float *target, plan_line_data_t *pl_data)
 // The arc is approximated by generating a huge number of tiny, linear segments. The chordal tolerance
 // of each segment is configured in settings.arc_tolerance, which is defined to be the maximum normal
 // distance from segment to the circle when the end points both lie on the circle.
+// NOTE: With ENABLE_LAZY_ARCS, only the segments that fit in the planner buffer are planned before
+// returning. The rest are planned by the main loop as blocks become free, or before the next motion.
 void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
   uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc)
 {
+  #ifdef ENABLE_LAZY_ARCS
+    mc_arc_flush(); // Complete a pending arc, before starting this one.
+  #endif
   float center_axis0 = position[axis_0] + offset[axis_0];
   float center_axis1 = position[axis_1] + offset[axis_1];
   float r_axis0 = -offset[axis_0];  // Radius vector from center to current location
@@ -106,8 +392,35 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
   // (2x) settings.arc_tolerance. For 99% of users, this is just fine. If a different arc segment fit
   // is desired, i.e. least-squares, midpoint on arc, just change the mm_per_arc_segment calculation.
   // For the intended uses of Grbl, this value shouldn't exceed 2000 for the strictest of cases.
-  uint16_t segments = floor(fabs(0.5*angular_travel*radius)/
-                          sqrt(settings.arc_tolerance*(2*radius - settings.arc_tolerance)) );
+  #ifdef ENABLE_ADAPTIVE_ARC_SEGMENTS
+    // Segment end points are placed outside the arc, so that the segments deviate from the arc by up
+    // to settings.arc_tolerance on either side. The half-angle alpha of a segment then follows from
+    // cos(alpha) = (radius-tolerance)/(radius+tolerance), for ~1.4x longer segments.
+    float sin_alpha = 2.0*sqrt(radius*settings.arc_tolerance)/(radius+settings.arc_tolerance);
+
+    // The planner limits the speed at each segment junction by the junction deviation and the turn
+    // of 2*alpha between segments, to v^2 = a*junction_deviation*cos(alpha)/(1-cos(alpha)). With
+    // segment end points on the arc, as without this option, that is a*junction_deviation*k with
+    // k = (radius-tolerance)/tolerance. Only a slower arc, at its feed rate or the max rates of the
+    // plane axes, keeps this speed with longer segments. So shorten the segments as needed, to keep
+    // the junction speed at the smaller of both speeds: cos(alpha) >= k/(1+k).
+    float k = max(radius-settings.arc_tolerance,0.0)/settings.arc_tolerance;
+    if (settings.junction_deviation > 0.0) {
+      float speed = pl_data->feed_rate;
+      if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) {
+        speed *= hypot_f(angular_travel*radius, target[axis_linear]-position[axis_linear]);
+      }
+      speed = min(speed, min(settings.max_rate[axis_0],settings.max_rate[axis_1]));
+      float acceleration = min(settings.acceleration[axis_0],settings.acceleration[axis_1]);
+      k = min(k, speed*speed/(acceleration*settings.junction_deviation));
+    }
+    float sin_alpha_speed = sqrt(1.0+2.0*k)/(1.0+k); // == sin(alpha) at cos(alpha) == k/(1+k)
+    if (sin_alpha > sin_alpha_speed) { sin_alpha = sin_alpha_speed; }
+    uint16_t segments = floor(fabs(0.5*angular_travel)/sin_alpha);
+  #else
+    uint16_t segments = floor(fabs(0.5*angular_travel*radius)/
+                            sqrt(settings.arc_tolerance*(2*radius - settings.arc_tolerance)) );
+  #endif
 
   if (segments) {
     // Multiply inverse feed_rate to compensate for the fact that this movement is approximated
@@ -119,7 +432,15 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
     }
     
     float theta_per_segment = angular_travel/segments;
-    float linear_per_segment = (target[axis_linear] - position[axis_linear])/segments;
+    arc.linear_per_segment = (target[axis_linear] - position[axis_linear])/segments;
+    #ifdef ENABLE_ADAPTIVE_ARC_SEGMENTS
+      // Scale the radius vector of the segment end points to 2*radius/(1+cos(alpha)), which centers
+      // the segments on the arc. Outside by arc_tolerance for the full tolerance segment length.
+      float cos_alpha = cos(0.5*theta_per_segment);
+      float radius_scale = 2.0/(1.0+cos_alpha);
+      r_axis0 *= radius_scale;
+      r_axis1 *= radius_scale;
+    #endif
 
     /* Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
        and phi is the angle of rotation. Solution approach by Jens Geisler.
@@ -146,55 +467,172 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
        a correction, the planner should have caught up to the lag caused by the initial mc_arc overhead.
        This is important when there are successive arc motions.
     */
-    // Computes: cos_T = 1 - theta_per_segment^2/2, sin_T = theta_per_segment - theta_per_segment^3/6) in ~52usec
-    float cos_T = 2.0 - theta_per_segment*theta_per_segment;
-    float sin_T = theta_per_segment*0.16666667*(cos_T + 4.0);
-    cos_T *= 0.5;
-
-    float sin_Ti;
-    float cos_Ti;
-    float r_axisi;
-    uint16_t i;
-    uint8_t count = 0;
-
-    for (i = 1; i<segments; i++) { // Increment (segments-1).
-
-      if (count < N_ARC_CORRECTION) {
-        // Apply vector rotation matrix. ~40 usec
-        r_axisi = r_axis0*sin_T + r_axis1*cos_T;
-        r_axis0 = r_axis0*cos_T - r_axis1*sin_T;
-        r_axis1 = r_axisi;
-        count++;
-      } else {
-        // Arc correction to radius vector. Computed only every N_ARC_CORRECTION increments. ~375 usec
-        // Compute exact location by applying transformation matrix from initial radius vector(=-offset).
-        cos_Ti = cos(i*theta_per_segment);
-        sin_Ti = sin(i*theta_per_segment);
-        r_axis0 = -offset[axis_0]*cos_Ti + offset[axis_1]*sin_Ti;
-        r_axis1 = -offset[axis_0]*sin_Ti - offset[axis_1]*cos_Ti;
-        count = 0;
-      }
+    #ifdef ENABLE_FIXED_POINT_ARCS
+      // Fixed-point vector rotation. The radius vector is scaled to Q29, where ARC_FIXED_ONE is the arc
+      // radius, and rotated with 32-bit integer products by sin(phi) and 1-cos(phi). Both coefficients
+      // are computed only once per arc, with ARC_FIXED_MANTISSA-bit mantissas, so that small segment
+      // angles keep their precision. Each rotation rounds to within ~2 units per component, so the
+      // radius vector is within ~2*segments units, or segments*radius*2^-28, of the exact arc point.
+      // This is below 0.001mm up to segments*radius = 268000mm, so no periodic correction with trig
+      // operations is needed. The final segment ends exactly at the target.
+      float sin_half_T = sin(0.5*theta_per_segment);
+      mc_arc_coefficient(sin(theta_per_segment), &arc.sin_T, &arc.sin_shift);
+      mc_arc_coefficient(2.0*sin_half_T*sin_half_T, &arc.vers_T, &arc.vers_shift); // 1-cos(phi)
+      arc.mm_per_unit = radius/ARC_FIXED_ONE;
+      #ifdef ENABLE_ADAPTIVE_ARC_SEGMENTS
+        arc.mm_per_unit *= radius_scale;
+      #endif
+      arc.q_axis0 = lround(r_axis0/arc.mm_per_unit);
+      arc.q_axis1 = lround(r_axis1/arc.mm_per_unit);
+    #else
+      // Computes: cos_T = 1 - theta_per_segment^2/2, sin_T = theta_per_segment - theta_per_segment^3/6) in ~52usec
+      arc.cos_T = 2.0 - theta_per_segment*theta_per_segment;
+      arc.sin_T = theta_per_segment*0.16666667*(arc.cos_T + 4.0);
+      arc.cos_T *= 0.5;
+      arc.r_axis0 = r_axis0;
+      arc.r_axis1 = r_axis1;
+      arc.offset_axis0 = -r_axis0;
+      arc.offset_axis1 = -r_axis1;
+      arc.theta_per_segment = theta_per_segment;
+      arc.count = 0;
+    #endif
+  } else {
+    segments = 1; // Only the final segment to the target.
+  }
+  memcpy(&arc.pl_data, pl_data, sizeof(plan_line_data_t));
+  memcpy(arc.target, target, sizeof(arc.target));
+  memcpy(arc.position, position, sizeof(arc.position));
+  arc.center_axis0 = center_axis0;
+  arc.center_axis1 = center_axis1;
+  arc.axis_0 = axis_0;
+  arc.axis_1 = axis_1;
+  arc.axis_linear = axis_linear;
+  arc.segment = 0;
+  arc.segments = segments;
+  mc_arc_generate(false);
+}
 
-      // Update arc_target location
-      position[axis_0] = center_axis0 + r_axis0;
-      position[axis_1] = center_axis1 + r_axis1;
-      position[axis_linear] += linear_per_segment;
 
-      mc_line(position, pl_data);
+#ifdef ENABLE_SPLINES
+  // Execute a G5 cubic spline in the XY plane. position == current xyz, target == target xyz,
+  // offset == offset from current xy to the first control point, end_offset_x/y == offset from
+  // target xy to the second control point. A G5.1 quadratic spline is passed as the equivalent cubic.
+  // The spline is approximated by line segments, each within settings.arc_tolerance of the curve.
+  // NOTE: With ENABLE_LAZY_ARCS, the segments are planned lazily, as they are for arcs.
+  void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *offset,
+    float end_offset_x, float end_offset_y)
+  {
+    #ifdef ENABLE_LAZY_ARCS
+      mc_arc_flush(); // Complete a pending arc or spline, before starting this one.
+    #endif
+    float end_offset[2] = { end_offset_x, end_offset_y };
+    uint8_t idx;
+    for (idx=0; idx<2; idx++) {
+      // Polynomial coefficients from the control points p0-p3 of the Bezier curve.
+      float p1 = position[idx] + offset[idx];
+      float p2 = target[idx] + end_offset[idx];
+      spline.a[idx] = target[idx] - 3.0*p2 + 3.0*p1 - position[idx];
+      spline.b[idx] = 3.0*(p2 - 2.0*p1 + position[idx]);
+      spline.c[idx] = 3.0*offset[idx];
+      spline.d[idx] = position[idx];
+    }
 
-      // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
-      if (sys.abort) { return; }
+    // As for arcs, convert the inverse feed rate of the spline to the feed rate of its segments. The
+    // spline length is estimated by the mean of its chord and control polygon lengths.
+    if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) {
+      float length = hypot_f(target[X_AXIS]-position[X_AXIS], target[Y_AXIS]-position[Y_AXIS]);
+      length += hypot_f(offset[X_AXIS], offset[Y_AXIS]) + hypot_f(end_offset_x, end_offset_y);
+      length += hypot_f(target[X_AXIS]+end_offset_x-position[X_AXIS]-offset[X_AXIS],
+                        target[Y_AXIS]+end_offset_y-position[Y_AXIS]-offset[Y_AXIS]);
+      pl_data->feed_rate *= 0.5*length;
+      bit_false(pl_data->condition,PL_COND_FLAG_INVERSE_TIME); // Force as feed absolute mode over spline segments.
     }
+
+    memcpy(&spline.pl_data, pl_data, sizeof(plan_line_data_t));
+    memcpy(spline.target, target, sizeof(spline.target));
+    memcpy(spline.position, position, sizeof(spline.position));
+    spline.t = 0.0;
+    spline.dt = 1.0; // First tries the whole spline as one segment.
+    mc_spline_generate(false);
   }
-  // Ensure last segment arrives at target location.
-  mc_line(target, pl_data);
-}
+#endif
+
+
+#ifdef ENABLE_CANNED_CYCLES
+  // Execute a G73 or G81-G83 canned drilling cycle at one hole. position == current xyz, which is
+  // updated to the final position, target == hole xyz, with the cycle axis at the hole bottom.
+  // r_level and clear_level are the cycle axis positions of the retract plane and the final retract.
+  // peck == G73/G83 peck depth, dwell == G82 dwell time in seconds, and cycle == the motion mode.
+  // NOTE: All motions above the retract plane and all retracts are rapids. Only drilling is fed.
+  void mc_canned_cycle(float *target, plan_line_data_t *pl_data, float *position, float r_level,
+    float clear_level, float peck, float dwell, uint8_t axis_linear, uint8_t cycle)
+  {
+    uint8_t condition = pl_data->condition;
+    float bottom = target[axis_linear];
+    float depth = r_level;
+    uint32_t n_peck = 1;
+    uint32_t i;
+    uint8_t idx;
+
+    // Rapid up to the retract plane, if below it. Then rapid over the hole and down to the plane.
+    pl_data->condition = condition | PL_COND_FLAG_RAPID_MOTION;
+    if (position[axis_linear] < r_level) {
+      position[axis_linear] = r_level;
+      mc_line(position, pl_data);
+    }
+    for (idx=0; idx<N_AXIS; idx++) {
+      if (idx != axis_linear) { position[idx] = target[idx]; }
+    }
+    mc_line(position, pl_data);
+    position[axis_linear] = r_level;
+    mc_line(position, pl_data);
+
+    // Drill to the bottom in one feed, or in pecks with a retract before each one after the first.
+    // The pecks are counted up front, so that the last one ends exactly at the bottom. A last peck
+    // under 0.1% of the peck depth is left by float rounding, and is merged into the one before.
+    if ((cycle == MOTION_MODE_DRILL_PECK) || (cycle == MOTION_MODE_DRILL_CHIP_BREAK)) {
+      n_peck = max(ceil((r_level-bottom)/peck - 0.001), 1);
+    }
+    for (i=1; i<=n_peck; i++) {
+      if (sys.abort) { return; } // Bail mid-cycle on system abort.
+      if (i > 1) {
+        pl_data->condition = condition | PL_COND_FLAG_RAPID_MOTION;
+        if (cycle == MOTION_MODE_DRILL_PECK) {
+          // G83: Clear the chips out of the hole at the retract plane.
+          position[axis_linear] = r_level;
+          mc_line(position, pl_data);
+        }
+        // Rapid to just above the depth drilled so far. For G73, a short retract to break the chip.
+        position[axis_linear] = min(depth+CANNED_CYCLE_PECK_RETRACT, r_level);
+        mc_line(position, pl_data);
+      }
+      if (i == n_peck) { depth = bottom; }
+      else { depth = r_level-i*peck; }
+      pl_data->condition = condition;
+      position[axis_linear] = depth;
+      mc_line(position, pl_data);
+    }
+
+    // Dwell at the bottom for G82, then retract out of the hole.
+    if (cycle == MOTION_MODE_DRILL_DWELL) { mc_dwell(dwell); }
+    pl_data->condition = condition | PL_COND_FLAG_RAPID_MOTION;
+    position[axis_linear] = clear_level;
+    mc_line(position, pl_data);
+    pl_data->condition = condition;
+  }
+#endif
 
 
 // Execute dwell in seconds.
 void mc_dwell(float seconds)
 {
-  if (sys.state == STATE_CHECK_MODE) { return; }
+  if (sys.state == STATE_CHECK_MODE) {
+    #ifdef ENABLE_CHECK_MODE_ESTIMATE
+      protocol_buffer_synchronize();
+      st_estimate_add_time(seconds);
+    #endif
+    return;
+  }
   protocol_buffer_synchronize();
   delay_sec(seconds, DELAY_MODE_DWELL);
 }
@@ -45,6 +45,54 @@ void mc_line(float *target, plan_line_data_t *pl_data);
 void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
   uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc);
 
+#ifdef ENABLE_SPLINES
+  // Smallest curve parameter step of a spline segment, which bounds the segments of a spline.
+  #ifndef SPLINE_MIN_STEP
+    #define SPLINE_MIN_STEP (1.0/16384)
+  #endif
+  // Fraction of the predicted spline segment step used, so that most predicted steps are accepted.
+  #define SPLINE_STEP_MARGIN 0.9
+
+  // Execute a G5 cubic spline in the XY plane. position == current xyz, target == target xyz,
+  // offset == offset from current xy to the first control point, end_offset_x/y == offset from
+  // target xy to the second control point.
+  void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *offset,
+    float end_offset_x, float end_offset_y);
+#endif
+
+#ifdef ENABLE_LAZY_ARCS
+  // Plans the next segments of a pending arc or spline into free planner blocks, without waiting.
+  // Called by the main loop.
+  void mc_arc_continue();
+
+  // Plans all remaining segments of a pending arc or spline, waiting for free planner blocks. Called
+  // before any other motion is planned and before the planner buffer is synchronized.
+  void mc_arc_flush();
+
+  // Discards a pending arc or spline. Called by the system abort/initialization routine.
+  void mc_arc_reset();
+#endif
+
+#ifdef ENABLE_FIXED_POINT_ARCS
+  // Fixed-point format of the arc radius vector. Q29, where ARC_FIXED_ONE is the arc radius. Leaves
+  // headroom for the rotation products of up to half circle segment angles.
+  #define ARC_FIXED_ONE 536870912.0 // 2^29
+  #define ARC_FIXED_MANTISSA 30 // Mantissa bits of the rotation coefficients
+#endif
+
+#ifdef ENABLE_CANNED_CYCLES
+  #ifndef CANNED_CYCLE_PECK_RETRACT
+    #define CANNED_CYCLE_PECK_RETRACT 0.254 // mm
+  #endif
+
+  // Execute a G73 or G81-G83 canned drilling cycle at one hole. position == current xyz, updated to
+  // the final position, target == hole xyz with the cycle axis at the hole bottom, r_level and
+  // clear_level == cycle axis retract plane and final retract positions, peck == G73/G83 peck depth,
+  // dwell == G82 dwell time, axis_linear == cycle axis, and cycle == canned cycle motion mode.
+  void mc_canned_cycle(float *target, plan_line_data_t *pl_data, float *position, float r_level,
+    float clear_level, float peck, float dwell, uint8_t axis_linear, uint8_t cycle);
+#endif
+
 // Dwell for a specific number of seconds
 void mc_dwell(float seconds);
 
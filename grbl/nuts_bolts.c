@@ -25,6 +25,33 @@
 #define MAX_INT_DIGITS 8 // Maximum number of digits in int32 (and float)
 
 
+#ifndef __AVR__
+  // Exact powers of ten for the decimal fast path. All are exactly representable as floats.
+  static const float pow10_table[MAX_INT_DIGITS+1] =
+    { 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0, 10000000.0, 100000000.0 };
+  #define EXACT_FLOAT_INT_MAX 16777216 // 2^24. Largest range of exactly representable float integers.
+
+  // Reads a run of decimal digits into intval. The digit count includes any overflow digits past
+  // MAX_INT_DIGITS, which are dropped, as in the AVR read_float() loop.
+  static char *read_digits(char *ptr, uint32_t *intval, uint8_t *ndigit)
+  {
+    uint32_t val = *intval;
+    uint8_t n = *ndigit;
+    uint8_t c;
+    while (1) {
+      c = *ptr - '0';
+      if (c > 9) { break; }
+      if (n < MAX_INT_DIGITS) { val = val*10 + c; }
+      n++;
+      ptr++;
+    }
+    *intval = val;
+    *ndigit = n;
+    return(ptr);
+  }
+#endif
+
+
 // Extracts a floating point value from a string. The following code is based loosely on
 // the avr-libc strtod() function by Michael Stumpf and Dmitry Xmelkov and many freely
 // available conversion method examples, but has been highly optimized for Grbl. For known
@@ -32,6 +59,10 @@
 // Scientific notation is officially not supported by g-code, and the 'E' character may
 // be a g-code word on some CNC systems. So, 'E' notation will not be recognized.
 // NOTE: Thanks to Radu-Eosif Mihailescu for identifying the issues with using strtod().
+// NOTE: On 32-bit and host targets, the integer and fraction digits are read by separate loops,
+// and typical values with up to 7 significant digits are converted with a single, correctly
+// rounded division by an exact power of ten. The AVR conversion is unchanged and rounds exactly
+// as before.
 uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr)
 {
   char *ptr = line + *char_counter;
@@ -53,24 +84,36 @@ uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr)
   uint32_t intval = 0;
   int8_t exp = 0;
   uint8_t ndigit = 0;
-  bool isdecimal = false;
-  while(1) {
-    c -= '0';
-    if (c <= 9) {
-      ndigit++;
-      if (ndigit <= MAX_INT_DIGITS) {
-        if (isdecimal) { exp--; }
-        intval = (((intval << 2) + intval) << 1) + c; // intval*10 + c
+  #ifdef __AVR__
+    bool isdecimal = false;
+    while(1) {
+      c -= '0';
+      if (c <= 9) {
+        ndigit++;
+        if (ndigit <= MAX_INT_DIGITS) {
+          if (isdecimal) { exp--; }
+          intval = (((intval << 2) + intval) << 1) + c; // intval*10 + c
+        } else {
+          if (!(isdecimal)) { exp++; }  // Drop overflow digits
+        }
+      } else if (c == (('.'-'0') & 0xff)  &&  !(isdecimal)) {
+        isdecimal = true;
       } else {
-        if (!(isdecimal)) { exp++; }  // Drop overflow digits
+        break;
       }
-    } else if (c == (('.'-'0') & 0xff)  &&  !(isdecimal)) {
-      isdecimal = true;
-    } else {
-      break;
+      c = *ptr++;
     }
-    c = *ptr++;
-  }
+  #else
+    // Integer digits, then fraction digits. Dropped overflow digits scale the integer part only.
+    ptr = read_digits(ptr-1, &intval, &ndigit);
+    if (ndigit > MAX_INT_DIGITS) { exp = ndigit - MAX_INT_DIGITS; }
+    if (*ptr == '.') {
+      uint8_t nkept = min(ndigit, MAX_INT_DIGITS);
+      ptr = read_digits(ptr+1, &intval, &ndigit);
+      exp -= min(ndigit, MAX_INT_DIGITS) - nkept;
+    }
+    ptr++; // Match the AVR loop, which leaves the pointer one past the terminating character.
+  #endif
 
   // Return if no digits have been read.
   if (!ndigit) { return(false); };
@@ -79,6 +122,15 @@ uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr)
   float fval;
   fval = (float)intval;
 
+  #ifndef __AVR__
+    // Exact-decimal fast path. The integer and power of ten are both exact floats, so the division
+    // rounds only once, to the nearest float of the decimal value.
+    if ((exp < 0) && (intval <= EXACT_FLOAT_INT_MAX)) {
+      fval /= pow10_table[-exp];
+      exp = 0;
+    }
+  #endif
+
   // Apply decimal. Should perform no more than two floating point multiplications for the
   // expected range of E0 to E-4.
   if (fval != 0) {
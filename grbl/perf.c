@@ -0,0 +1,82 @@
+/*
+  perf.c - Performance counters for profiling the main program
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_PERF_COUNTERS
+
+perf_timer_t perf_timer[N_PERF_TIMER];
+volatile uint16_t perf_event[N_PERF_EVENT];
+uint32_t perf_count[N_PERF_COUNT];
+
+// The time base counts spindle timer overflows, every 256 timer ticks, as the upper bits of the
+// time in ticks. The timer keeps running through resets, which don't touch its count registers.
+static volatile uint32_t perf_overflow_count;
+
+
+void perf_init()
+{
+  #ifndef VARIABLE_SPINDLE
+    SPINDLE_TCCRA_REGISTER = 0; // Normal mode
+    SPINDLE_TCCRB_REGISTER = SPINDLE_TIMER_CS;
+  #endif
+  SPINDLE_TIMSK_REGISTER |= (1<<SPINDLE_TOIE_BIT); // Enable overflow interrupt.
+  perf_reset();
+}
+
+
+void perf_reset()
+{
+  uint8_t sreg = SREG;
+  cli();
+  memset(perf_timer, 0, sizeof(perf_timer));
+  memset((void*)perf_event, 0, sizeof(perf_event));
+  memset(perf_count, 0, sizeof(perf_count));
+  SREG = sreg;
+}
+
+
+ISR(SPINDLE_TIMER_OVF_vect) { perf_overflow_count++; }
+
+
+uint32_t perf_get_ticks()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t overflow_count = perf_overflow_count;
+  uint8_t count = SPINDLE_TCNT_REGISTER;
+  // Account for an overflow that occurred after interrupts were disabled, but is yet to be serviced.
+  if ((SPINDLE_TIFR_REGISTER & (1<<SPINDLE_TOV_BIT)) && (count != 0xff)) { overflow_count++; }
+  SREG = sreg;
+  return((overflow_count << 8) | count);
+}
+
+
+void perf_record(uint8_t timer, uint32_t start_ticks)
+{
+  uint32_t ticks = perf_get_ticks()-start_ticks;
+  perf_timer_t *pt = &perf_timer[timer];
+  pt->count++;
+  pt->total += ticks;
+  if (ticks > 0xffff) { ticks = 0xffff; }
+  if (ticks > pt->max) { pt->max = ticks; }
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+  perf.h - Performance counters for profiling the main program
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef perf_h
+#define perf_h
+
+// Define performance timer indices. Each times the calls of one main program function.
+#define PERF_TIMER_GC_EXECUTE       0 // gc_execute_line() of streamed g-code blocks
+#define PERF_TIMER_PLAN_BUFFER      1 // plan_buffer_line() of mc_line() motions
+#define PERF_TIMER_PLAN_RECALCULATE 2 // planner_recalculate()
+#define PERF_TIMER_ST_PREP          3 // st_prep_buffer() of the realtime protocol
+#define PERF_TIMER_MC_ARC           4 // mc_arc()
+#define PERF_TIMER_STATUS_REPORT    5 // report_realtime_status()
+#define PERF_TIMER_PLANNER_FULL     6 // Waits for a free planner block in mc_line()
+#define N_PERF_TIMER 7
+
+// Define performance event counter indices. Counted by interrupts.
+#define PERF_EVENT_RX_OVERFLOW      0 // Serial characters dropped with the RX buffer full
+#define PERF_EVENT_SEGMENT_UNDERRUN 1 // Segment buffer emptied before the planner block completed
+#define N_PERF_EVENT 2
+
+// Define performance count indices. Counted by the main program.
+#define PERF_COUNT_SEGMENT          0 // Step segments prepared by st_prep_buffer()
+#define PERF_COUNT_RECALC_BLOCK     1 // Blocks visited by the planner_recalculate() passes
+#define N_PERF_COUNT 2
+
+// Performance timer data. Times are in spindle timer ticks.
+typedef struct {
+  uint32_t count; // Number of timed calls
+  uint32_t total; // Total time of all calls
+  uint16_t max;   // Longest call. Saturates at 0xffff.
+} perf_timer_t;
+extern perf_timer_t perf_timer[N_PERF_TIMER];
+extern volatile uint16_t perf_event[N_PERF_EVENT];
+extern uint32_t perf_count[N_PERF_COUNT];
+
+// Microseconds per perf timer tick.
+#define PERF_US_PER_TICK (SPINDLE_TIMER_PRESCALER/(F_CPU/1000000.0))
+
+
+// Starts the perf timer time base. Called once at power-up.
+void perf_init();
+
+// Clears all performance timers, event counters and counts.
+void perf_reset();
+
+// Returns the current time in perf timer ticks.
+uint32_t perf_get_ticks();
+
+// Records the time of a call to the given performance timer, from its start time in ticks.
+void perf_record(uint8_t timer, uint32_t start_ticks);
+
+// Increments an event counter. Called only by interrupts.
+#define perf_count_event(event) { if (perf_event[event] != 0xffff) { perf_event[event]++; } }
+
+#endif
@@ -147,6 +147,9 @@ static void planner_recalculate()
     if (block_index == block_buffer_tail) { st_update_plan_block_parameters(); }
   } else { // Three or more plan-able blocks
     while (block_index != block_buffer_planned) {
+      #ifdef ENABLE_PERF_COUNTERS
+        perf_count[PERF_COUNT_RECALC_BLOCK]++;
+      #endif
       next = current;
       current = &block_buffer[block_index];
       block_index = plan_prev_block_index(block_index);
@@ -171,6 +174,9 @@ static void planner_recalculate()
   next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
   block_index = plan_next_block_index(block_buffer_planned);
   while (block_index != block_buffer_head) {
+    #ifdef ENABLE_PERF_COUNTERS
+      perf_count[PERF_COUNT_RECALC_BLOCK]++;
+    #endif
     current = next;
     next = &block_buffer[block_index];
 
@@ -324,6 +330,9 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
   #ifdef USE_LINE_NUMBERS
     block->line_number = pl_data->line_number;
   #endif
+  #ifdef ENABLE_LASER_RASTER
+    block->raster_count = pl_data->raster_count;
+  #endif
 
   // Compute and store initial move distance data.
   int32_t target_steps[N_AXIS], position_steps[N_AXIS];
@@ -379,6 +388,10 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
 
   // Bail if this is a zero-length block. Highly unlikely to occur.
   if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+  #ifdef ENABLE_LASER_RASTER
+    // The stepper ISR traces raster pixels as a Bresenham axis. Each pixel requires at least one step.
+    if (block->step_event_count < block->raster_count) { return(PLAN_EMPTY_BLOCK); }
+  #endif
 
   // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
   // down such that no individual axes maximum values are exceeded with respect to the line direction.
@@ -466,7 +479,13 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     next_buffer_head = plan_next_block_index(block_buffer_head);
 
     // Finish up by recalculating the plan with the new block.
-    planner_recalculate();
+    #ifdef ENABLE_PERF_COUNTERS
+      uint32_t perf_start = perf_get_ticks();
+      planner_recalculate();
+      perf_record(PERF_TIMER_PLAN_RECALCULATE,perf_start);
+    #else
+      planner_recalculate();
+    #endif
   }
   return(PLAN_OK);
 }
@@ -511,6 +530,20 @@ uint8_t plan_get_block_buffer_count()
 }
 
 
+// Returns the time in minutes to execute the planner buffer at the nominal speeds of its blocks.
+// NOTE: Acceleration is not accounted, so the actual time is somewhat longer.
+float plan_get_block_buffer_time()
+{
+  float time = 0.0;
+  uint8_t block_index = block_buffer_tail;
+  while (block_index != block_buffer_head) {
+    time += block_buffer[block_index].millimeters/plan_compute_profile_nominal_speed(&block_buffer[block_index]);
+    block_index = plan_next_block_index(block_index);
+  }
+  return(time);
+}
+
+
 // Re-initialize buffer plan with a partially completed block, assumed to exist at the buffer tail.
 // Called after a steppers have come to a complete stop for a feed hold and the cycle is stopped.
 void plan_cycle_reinitialize()
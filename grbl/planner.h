@@ -83,6 +83,9 @@ typedef struct {
     // Stored spindle speed data used by spindle overrides and resuming methods.
     float spindle_speed;    // Block spindle speed. Copied from pl_line_data.
   #endif
+  #ifdef ENABLE_LASER_RASTER
+    uint8_t raster_count;   // Number of raster pixels traced over the block. Zero if not a scanline.
+  #endif
 } plan_block_t;
 
 
@@ -94,6 +97,9 @@ typedef struct {
   #ifdef USE_LINE_NUMBERS
     int32_t line_number;    // Desired line number to report when executing.
   #endif
+  #ifdef ENABLE_LASER_RASTER
+    uint8_t raster_count;   // Number of raster scanline pixels queued for this motion.
+  #endif
 } plan_line_data_t;
 
 
@@ -141,6 +147,10 @@ uint8_t plan_get_block_buffer_available();
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
 uint8_t plan_get_block_buffer_count();
 
+// Returns the time in minutes to execute the planner buffer at nominal speeds. Used by program mode
+// and the benchmark.
+float plan_get_block_buffer_time();
+
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
 
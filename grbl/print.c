@@ -94,23 +94,51 @@ void print_uint8_base2_ndigit(uint8_t n, uint8_t digits) {
 }
 
 
-void print_uint32_base10(uint32_t n)
-{
-  if (n == 0) {
-    serial_write('0');
-    return;
+// Prints an uint32 variable in base 16 with the desired number of digits.
+void print_uint32_base16_ndigit(uint32_t n, uint8_t digits) {
+  uint8_t nibble;
+  while (digits) {
+    digits--;
+    nibble = (n >> (digits << 2)) & 0x0f;
+    if (nibble < 10) { serial_write('0' + nibble); }
+    else { serial_write('A' - 10 + nibble); }
   }
+}
 
-  unsigned char buf[10];
-  uint8_t i = 0;
 
-  while (n > 0) {
-    buf[i++] = n % 10;
-    n /= 10;
+// Powers of ten for the decimal digit generator. The units digit is not included.
+static const uint32_t print_pow10[9] PROGMEM = { 1000000000, 100000000, 10000000, 1000000,
+                                                 100000, 10000, 1000, 100, 10 };
+
+// Prints an uint32 variable in base 10 with the given number of implied decimal places, such as
+// 12345 as 12.345 for three places. Digits are generated from the most significant by repeated
+// subtraction of powers of ten, at most nine 32-bit subtractions per digit.
+void print_uint32_fixed(uint32_t n, uint8_t decimal_places)
+{
+  uint8_t idx, digit;
+  uint8_t started = false;
+  uint32_t pow10;
+  for (idx=0; idx<9; idx++) {
+    pow10 = pgm_read_dword_near(&print_pow10[idx]);
+    digit = '0';
+    while (n >= pow10) {
+      n -= pow10;
+      digit++;
+    }
+    // Skip leading zeros, but always print the units digit and any zeros after the decimal point.
+    if (started || (digit != '0') || ((9-idx) <= decimal_places)) {
+      serial_write(digit);
+      started = true;
+      if ((9-idx) == decimal_places) { serial_write('.'); } // Insert decimal point after units digit.
+    }
   }
+  serial_write('0'+n);
+}
 
-  for (; i > 0; i--)
-    serial_write('0' + buf[i-1]);
+
+void print_uint32_base10(uint32_t n)
+{
+  print_uint32_fixed(n,0);
 }
 
 
@@ -127,7 +155,7 @@ void printInteger(long n)
 
 // Convert float to string by immediately converting to a long integer, which contains
 // more digits than a float. Number of decimal places, which are tracked by a counter,
-// may be set by the user. The integer is then efficiently converted to a string.
+// may be set by the user. The integer is then converted to a string as a fixed-point value.
 // NOTE: AVR '%' and '/' integer operations are very efficient. Bitshifting speed-up
 // techniques are actually just slightly slower. Found this out the hard way.
 void printFloat(float n, uint8_t decimal_places)
@@ -145,26 +173,7 @@ void printFloat(float n, uint8_t decimal_places)
   if (decimals) { n *= 10; }
   n += 0.5; // Add rounding factor. Ensures carryover through entire value.
 
-  // Generate digits backwards and store in string.
-  unsigned char buf[13];
-  uint8_t i = 0;
-  uint32_t a = (long)n;
-  while(a > 0) {
-    buf[i++] = (a % 10) + '0'; // Get digit
-    a /= 10;
-  }
-  while (i < decimal_places) {
-     buf[i++] = '0'; // Fill in zeros to decimal point for (n < 1)
-  }
-  if (i == decimal_places) { // Fill in leading zero, if needed.
-    buf[i++] = '0';
-  }
-
-  // Print the generated string.
-  for (; i > 0; i--) {
-    if (i == decimal_places) { serial_write('.'); } // Insert decimal point in right place.
-    serial_write(buf[i-1]);
-  }
+  print_uint32_fixed((long)n, decimal_places);
 }
 
 
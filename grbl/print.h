@@ -31,12 +31,18 @@ void printInteger(long n);
 
 void print_uint32_base10(uint32_t n);
 
+// Prints an uint32 variable in base 10 as a fixed-point value with the given implied decimal places.
+void print_uint32_fixed(uint32_t n, uint8_t decimal_places);
+
 // Prints an uint8 variable in base 10.
 void print_uint8_base10(uint8_t n);
 
 // Prints an uint8 variable in base 2 with desired number of desired digits.
 void print_uint8_base2_ndigit(uint8_t n, uint8_t digits);
 
+// Prints an uint32 variable in base 16 with desired number of digits.
+void print_uint32_base16_ndigit(uint32_t n, uint8_t digits);
+
 void printFloat(float n, uint8_t decimal_places);
 
 // Floating value printing handlers for special variables types used in Grbl.
@@ -21,16 +21,16 @@
 
 #include "grbl.h"
 
-// Define line flags. Includes comment type tracking and line overflow detection.
-#define LINE_FLAG_OVERFLOW bit(0)
-#define LINE_FLAG_COMMENT_PARENTHESES bit(1)
-#define LINE_FLAG_COMMENT_SEMICOLON bit(2)
-
-
 static char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
 
 static void protocol_exec_rt_suspend();
 
+#ifdef ENABLE_PROGRAM_MODE
+  static uint8_t program_mode; // True between the '%' delimiters of a program.
+  static uint8_t program_hold_count; // Planner blocks queued, when the hold timeout was last restarted.
+  static uint16_t program_hold_ms; // Time waited for more blocks, while holding the cycle start.
+#endif
+
 
 /*
   GRBL PRIMARY LOOP:
@@ -71,11 +71,20 @@ void protocol_main_loop()
   uint8_t line_flags = 0;
   uint8_t char_counter = 0;
   uint8_t c;
+  #ifdef ENABLE_PROGRAM_MODE
+    program_mode = false; // A reset ends any program.
+  #endif
   for (;;) {
 
     // Process one line of incoming serial data, as the data becomes available. Performs an
     // initial filtering by removing spaces and comments and capitalizing all letters.
-    while((c = serial_read()) != SERIAL_NO_DATA) {
+    // NOTE: While a chunked report is printing, further lines are left in the serial read buffer,
+    // so that their responses follow the report.
+    while(
+      #ifdef ENABLE_CHUNKED_REPORTS
+        !report_chunked_continue() &&
+      #endif
+        ((c = serial_read()) != SERIAL_NO_DATA)) {
       if ((c == '\n') || (c == '\r')) { // End of line reached
 
         protocol_execute_realtime(); // Runtime command check point.
@@ -96,12 +105,29 @@ void protocol_main_loop()
         } else if (line[0] == '$') {
           // Grbl '$' system command
           report_status_message(system_execute_line(line));
+        #ifdef ENABLE_PROGRAM_STORAGE
+          } else if (storage_get_state() != STORAGE_IDLE) {
+            // Store a line of an uploaded program. G-code is locked out while a stored program runs.
+            report_status_message(storage_input_line(line));
+        #endif
         } else if (sys.state & (STATE_ALARM | STATE_JOG)) {
           // Everything else is gcode. Block if in alarm or jog mode.
           report_status_message(STATUS_SYSTEM_GC_LOCK);
+        #ifdef ENABLE_SUBPROGRAMS
+          } else if ((line[0] == 'O') || subprogram_is_recording()) {
+            // Execute an O-word statement, or store a line of a subprogram definition.
+            report_status_message(subprogram_execute_line(line));
+        #endif
         } else {
           // Parse and execute g-code block.
-          report_status_message(gc_execute_line(line));
+          #ifdef ENABLE_PERF_COUNTERS
+            uint32_t perf_start = perf_get_ticks();
+            uint8_t status_code = gc_execute_line(line);
+            perf_record(PERF_TIMER_GC_EXECUTE,perf_start);
+            report_status_message(status_code);
+          #else
+            report_status_message(gc_execute_line(line));
+          #endif
         }
 
         // Reset tracking data for next line.
@@ -109,52 +135,32 @@ void protocol_main_loop()
         char_counter = 0;
 
       } else {
-
-        if (line_flags) {
-          // Throw away all (except EOL) comment characters and overflow characters.
-          if (c == ')') {
-            // End of '()' comment. Resume line allowed.
-            if (line_flags & LINE_FLAG_COMMENT_PARENTHESES) { line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES); }
-          }
-        } else {
-          if (c <= ' ') {
-            // Throw away whitepace and control characters
-          } else if (c == '/') {
-            // Block delete NOT SUPPORTED. Ignore character.
-            // NOTE: If supported, would simply need to check the system if block delete is enabled.
-          } else if (c == '(') {
-            // Enable comments flag and ignore all characters until ')' or EOL.
-            // NOTE: This doesn't follow the NIST definition exactly, but is good enough for now.
-            // In the future, we could simply remove the items within the comments, but retain the
-            // comment control characters, so that the g-code parser can error-check it.
-            line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
-          } else if (c == ';') {
-            // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
-            line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
-          // TODO: Install '%' feature
-          // } else if (c == '%') {
-            // Program start-end percent sign NOT SUPPORTED.
-            // NOTE: This maybe installed to tell Grbl when a program is running vs manual input,
-            // where, during a program, the system auto-cycle start will continue to execute
-            // everything until the next '%' sign. This will help fix resuming issues with certain
-            // functions that empty the planner buffer to execute its task on-time.
-          } else if (char_counter >= (LINE_BUFFER_SIZE-1)) {
-            // Detect line buffer overflow and set flag.
-            line_flags |= LINE_FLAG_OVERFLOW;
-          } else if (c >= 'a' && c <= 'z') { // Upcase lowercase
-            line[char_counter++] = c-'a'+'A';
-          } else {
-            line[char_counter++] = c;
-          }
-        }
-
+        protocol_filter_char(line,&char_counter,&line_flags,c);
       }
     }
 
+    #ifdef ENABLE_PROGRAM_STORAGE
+      // Execute the next line of a running stored program, once serial input is processed.
+      if (storage_get_state() == STORAGE_RUNNING) {
+        storage_execute_next_line();
+        if (sys.abort) { return; }
+      }
+    #endif
+
+    #ifdef ENABLE_LAZY_ARCS
+      // Plan more segments of a pending arc into the planner blocks freed since the last pass.
+      mc_arc_continue();
+    #endif
+
     // If there are no more characters in the serial read buffer to be processed and executed,
     // this indicates that g-code streaming has either filled the planner buffer or has
     // completed. In either case, auto-cycle start, if enabled, any queued moves.
-    protocol_auto_cycle_start();
+    #ifdef ENABLE_PROGRAM_MODE
+      // Within a program, a pause in streaming only starts the cycle, once the planner is primed.
+      if (protocol_program_primed()) { protocol_auto_cycle_start(); }
+    #else
+      protocol_auto_cycle_start();
+    #endif
 
     protocol_execute_realtime();  // Runtime command check point.
     if (sys.abort) { return; } // Bail to main() program loop to reset system.
@@ -164,10 +170,63 @@ void protocol_main_loop()
 }
 
 
+// Adds a character of an incoming line to the line buffer. Performs an initial filtering by removing
+// spaces and comments and capitalizing all letters, and flags a line buffer overflow.
+void protocol_filter_char(char *line, uint8_t *char_counter, uint8_t *line_flags, uint8_t c)
+{
+  if (*line_flags) {
+    // Throw away all (except EOL) comment characters and overflow characters.
+    if (c == ')') {
+      // End of '()' comment. Resume line allowed.
+      if (*line_flags & LINE_FLAG_COMMENT_PARENTHESES) { *line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES); }
+    }
+  } else {
+    if (c <= ' ') {
+      // Throw away whitepace and control characters
+    } else if (c == '/') {
+      // Block delete NOT SUPPORTED. Ignore character.
+      // NOTE: If supported, would simply need to check the system if block delete is enabled.
+    } else if (c == '(') {
+      // Enable comments flag and ignore all characters until ')' or EOL.
+      // NOTE: This doesn't follow the NIST definition exactly, but is good enough for now.
+      // In the future, we could simply remove the items within the comments, but retain the
+      // comment control characters, so that the g-code parser can error-check it.
+      *line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
+    } else if (c == ';') {
+      // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
+      *line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
+    #ifdef ENABLE_PROGRAM_MODE
+      } else if (c == '%') {
+        // Program start-end percent sign. Tells Grbl when a program is running vs manual input,
+        // so that the auto-cycle start waits for a primed planner buffer during a program.
+        program_mode = !program_mode;
+    #endif
+    } else if (*char_counter >= (LINE_BUFFER_SIZE-1)) {
+      // Detect line buffer overflow and set flag.
+      *line_flags |= LINE_FLAG_OVERFLOW;
+    } else if (c >= 'a' && c <= 'z') { // Upcase lowercase
+      line[(*char_counter)++] = c-'a'+'A';
+    } else {
+      line[(*char_counter)++] = c;
+    }
+  }
+}
+
+
 // Block until all buffered steps are executed or in a cycle state. Works with feed hold
 // during a synchronize call, if it should happen. Also, waits for clean cycle end.
 void protocol_buffer_synchronize()
 {
+  #ifdef ENABLE_LAZY_ARCS
+    mc_arc_flush(); // The remaining segments of a pending arc are part of the buffered motion.
+  #endif
+  #ifdef ENABLE_CHECK_MODE_ESTIMATE
+    // In check mode, execute all buffered motions on the estimator virtual clock instead.
+    if (sys.state == STATE_CHECK_MODE) {
+      st_estimate_execute(true);
+      return;
+    }
+  #endif
   // If system is queued, ensure cycle resumes if the auto start flag is present.
   protocol_auto_cycle_start();
   do {
@@ -191,6 +250,40 @@ void protocol_auto_cycle_start()
 }
 
 
+#ifdef ENABLE_PROGRAM_MODE
+  // Returns true, when the main loop may auto-cycle start the queued motions. Outside of a program,
+  // this is as soon as streaming pauses. During a program, starting a cycle from IDLE is held until
+  // the planner buffer is primed with PROGRAM_MODE_PRIME_BLOCKS blocks or PROGRAM_MODE_PRIME_TIME
+  // of motion, so that a short pause of the host doesn't start the motion with a nearly empty
+  // planner, only to decelerate to a stop soon after. If no more blocks arrive within
+  // PROGRAM_MODE_TIMEOUT, the cycle starts anyway. The closing '%' ends the hold immediately.
+  // NOTE: Buffer syncs and a full planner buffer always start the cycle, as before.
+  uint8_t protocol_program_primed()
+  {
+    if (program_mode && (sys.state == STATE_IDLE)) {
+      uint8_t block_count = plan_get_block_buffer_count();
+      if ((block_count != 0) && (block_count < PROGRAM_MODE_PRIME_BLOCKS) &&
+          (plan_get_block_buffer_time() < (PROGRAM_MODE_PRIME_TIME/60.0))) {
+        if (block_count != program_hold_count) {
+          // More blocks arrived. Restart the timeout.
+          program_hold_count = block_count;
+          program_hold_ms = 0;
+          return(false);
+        }
+        if (program_hold_ms < PROGRAM_MODE_TIMEOUT) {
+          // Called only while the serial read buffer is empty. Wait for more data in small steps.
+          delay_ms(1);
+          program_hold_ms++;
+          return(false);
+        }
+      }
+    }
+    program_hold_count = 0; // Start the timeout over with the next hold.
+    return(true);
+  }
+#endif
+
+
 // This function is the general interface to Grbl's real-time command execution system. It is called
 // from various check points in the main program, primarily where there may be a while loop waiting
 // for a buffer to clear space or any point where the execution time from the last check point may
@@ -237,6 +330,11 @@ void protocol_exec_rt_system()
     system_clear_exec_alarm(); // Clear alarm
   }
 
+  #ifdef ENABLE_AUTO_STATUS_REPORT
+    // Execute and serial print a periodic status report, when the auto report interval has elapsed.
+    if (report_auto_pending) { report_auto_status(); }
+  #endif
+
   rt_exec = sys_rt_exec_state; // Copy volatile sys_rt_exec_state.
   if (rt_exec) {
 
@@ -248,8 +346,16 @@ void protocol_exec_rt_system()
 
     // Execute and serial print status
     if (rt_exec & EXEC_STATUS_REPORT) {
-      report_realtime_status();
-      system_clear_exec_state_flag(EXEC_STATUS_REPORT);
+      #ifdef ENABLE_CHUNKED_REPORTS
+        // Print the report fields the serial TX buffer has room for, rather than wait on it. The
+        // rest are printed on the following passes.
+        if (report_realtime_status_continue())
+      #else
+        report_realtime_status();
+      #endif
+      {
+        system_clear_exec_state_flag(EXEC_STATUS_REPORT);
+      }
     }
 
     // NOTE: Once hold is initiated, the system immediately enters a suspend state to block all
@@ -495,7 +601,13 @@ void protocol_exec_rt_system()
 
   // Reload step segment buffer
   if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP| STATE_JOG)) {
-    st_prep_buffer();
+    #ifdef ENABLE_PERF_COUNTERS
+      uint32_t perf_start = perf_get_ticks();
+      st_prep_buffer();
+      perf_record(PERF_TIMER_ST_PREP,perf_start);
+    #else
+      st_prep_buffer();
+    #endif
   }
 
 }
@@ -675,7 +787,11 @@ static void protocol_exec_rt_suspend()
                   bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_PWM);
                 } else {
                   spindle_set_state((restore_condition & (PL_COND_FLAG_SPINDLE_CW | PL_COND_FLAG_SPINDLE_CCW)), restore_spindle_speed);
-                  delay_sec(SAFETY_DOOR_SPINDLE_DELAY, DELAY_MODE_SYS_SUSPEND);
+                  #ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+                    spindle_wait_at_speed(SPINDLE_STATE_DISABLE, 0.0, DELAY_MODE_SYS_SUSPEND);
+                  #else
+                    delay_sec(SAFETY_DOOR_SPINDLE_DELAY, DELAY_MODE_SYS_SUSPEND);
+                  #endif
                 }
               }
             }
@@ -740,6 +856,9 @@ static void protocol_exec_rt_suspend()
                 bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_PWM);
               } else {
                 spindle_set_state((restore_condition & (PL_COND_FLAG_SPINDLE_CW | PL_COND_FLAG_SPINDLE_CCW)), restore_spindle_speed);
+                #ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+                  spindle_wait_at_speed(SPINDLE_STATE_DISABLE, 0.0, DELAY_MODE_SYS_SUSPEND);
+                #endif
               }
             }
             if (sys.spindle_stop_ovr & SPINDLE_STOP_OVR_RESTORE_CYCLE) {
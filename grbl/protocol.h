@@ -32,6 +32,24 @@
   #define LINE_BUFFER_SIZE 80
 #endif
 
+// Program mode priming. During a '%' program, the auto-cycle start waits for this many planner
+// blocks (integer) or seconds of motion (float), but no longer than the timeout (milliseconds) after
+// the last block arrived.
+#ifndef PROGRAM_MODE_PRIME_BLOCKS
+  #define PROGRAM_MODE_PRIME_BLOCKS 8
+#endif
+#ifndef PROGRAM_MODE_PRIME_TIME
+  #define PROGRAM_MODE_PRIME_TIME 1.0
+#endif
+#ifndef PROGRAM_MODE_TIMEOUT
+  #define PROGRAM_MODE_TIMEOUT 500
+#endif
+
+// Define line flags. Includes comment type tracking and line overflow detection.
+#define LINE_FLAG_OVERFLOW bit(0)
+#define LINE_FLAG_COMMENT_PARENTHESES bit(1)
+#define LINE_FLAG_COMMENT_SEMICOLON bit(2)
+
 // Starts Grbl main loop. It handles all incoming characters from the serial port and executes
 // them as they complete. It is also responsible for finishing the initialization procedures.
 void protocol_main_loop();
@@ -40,9 +58,17 @@ void protocol_main_loop();
 void protocol_execute_realtime();
 void protocol_exec_rt_system();
 
+// Adds a character of an incoming line to the line buffer, filtering spaces and comments.
+void protocol_filter_char(char *line, uint8_t *char_counter, uint8_t *line_flags, uint8_t c);
+
 // Executes the auto cycle feature, if enabled.
 void protocol_auto_cycle_start();
 
+#ifdef ENABLE_PROGRAM_MODE
+  // Returns true, when the planner is primed enough for the auto cycle start during a '%' program.
+  uint8_t protocol_program_primed();
+#endif
+
 // Block until all buffered steps are executed
 void protocol_buffer_synchronize();
 
@@ -0,0 +1,181 @@
+/*
+  raster.c - Laser raster scanline methods
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_LASER_RASTER
+
+// Raster pixel ring buffer. Filled by the main program with the pixel runs of planned scanlines
+// and consumed in order by the stepper ISR, as it crosses the pixel boundaries of each block.
+static uint8_t raster_buffer[RASTER_BUFFER_SIZE];
+static uint8_t raster_buffer_head;
+static volatile uint8_t raster_buffer_tail;
+
+
+void raster_reset()
+{
+  raster_buffer_head = 0;
+  raster_buffer_tail = 0;
+}
+
+
+// Returns the number of available bytes in the raster pixel buffer.
+static uint8_t raster_get_buffer_available()
+{
+  uint8_t rtail = raster_buffer_tail; // Copy to limit multiple calls to volatile
+  if (raster_buffer_head >= rtail) { return((RASTER_BUFFER_SIZE-1)-(raster_buffer_head-rtail)); }
+  return((rtail-raster_buffer_head-1));
+}
+
+
+// Returns the next queued pixel. The planner guarantees every pixel of an executing raster block
+// has been queued, so the stepper ISR never finds this buffer empty.
+uint8_t raster_get_next_pixel()
+{
+  uint8_t tail = raster_buffer_tail;
+  uint8_t pixel = raster_buffer[tail];
+  if (++tail == RASTER_BUFFER_SIZE) { tail = 0; }
+  raster_buffer_tail = tail;
+  return(pixel);
+}
+
+
+// Converts a hex character to its value. Returns 0xff, if not a valid hex digit.
+static uint8_t raster_hex_to_value(char c)
+{
+  if (c >= '0' && c <= '9') { return(c-'0'); }
+  if (c >= 'A' && c <= 'F') { return(c-'A'+10); }
+  return(0xff);
+}
+
+
+// Executes a '$L' raster scanline command in the form '$LX0.1Y0F3000=00FF7F..'. The axis words
+// define the pixel pitch vector in the current units, the optional F word a feed rate in units
+// per minute, and the hex characters after '=' the 8-bit laser power of each pixel. The scanline
+// starts at the current parser position and is planned as a single line motion. The stepper ISR
+// scales the laser power of each segment by the power of the pixel being traced.
+// NOTE: The decoded pixel values are stored in place over the line buffer as they are parsed.
+uint8_t raster_execute_line(char *line)
+{
+  if (bit_isfalse(settings.flags,BITFLAG_LASER_MODE)) { return(STATUS_SETTING_DISABLED); }
+
+  float pitch[N_AXIS];
+  float feed_rate = gc_state.feed_rate;
+  float value;
+  uint8_t word_bits = 0;
+  uint8_t char_counter = 2;
+  uint8_t idx;
+  char letter;
+  memset(pitch, 0, sizeof(pitch));
+
+  // Parse pixel pitch axis words and feed rate word up to the pixel data delimiter.
+  while ((letter = line[char_counter]) != '=') {
+    if (letter == 0) { return(STATUS_INVALID_STATEMENT); }
+    char_counter++;
+    if (!read_float(line, &char_counter, &value)) { return(STATUS_BAD_NUMBER_FORMAT); }
+    if (gc_state.modal.units == UNITS_MODE_INCHES) { value *= MM_PER_INCH; }
+    switch(letter) {
+      case 'X': idx = X_AXIS; break;
+      case 'Y': idx = Y_AXIS; break;
+      case 'Z': idx = Z_AXIS; break;
+      case 'F': idx = N_AXIS; break;
+      default: return(STATUS_GCODE_UNSUPPORTED_COMMAND);
+    }
+    if (bit_istrue(word_bits,bit(idx))) { return(STATUS_GCODE_WORD_REPEATED); }
+    word_bits |= bit(idx);
+    if (idx == N_AXIS) { feed_rate = value; }
+    else { pitch[idx] = value; }
+  }
+  if (!(word_bits & (bit(N_AXIS)-1))) { return(STATUS_GCODE_NO_AXIS_WORDS); }
+  if (feed_rate <= 0.0) { return(STATUS_GCODE_UNDEFINED_FEED_RATE); }
+
+  // Decode the hex-packed pixel run. Two characters per pixel.
+  uint8_t pixel_count = 0;
+  uint8_t nibble_hi, nibble_lo;
+  char_counter++;
+  while (line[char_counter] != 0) {
+    nibble_hi = raster_hex_to_value(line[char_counter++]);
+    nibble_lo = raster_hex_to_value(line[char_counter]);
+    if ((nibble_hi | nibble_lo) & 0xf0) { return(STATUS_BAD_NUMBER_FORMAT); }
+    char_counter++;
+    line[pixel_count++] = (nibble_hi << 4) | nibble_lo;
+  }
+  if ((pixel_count == 0) || (pixel_count >= RASTER_BUFFER_SIZE)) { return(STATUS_INVALID_STATEMENT); }
+
+  float target[N_AXIS];
+  for (idx=0; idx<N_AXIS; idx++) { target[idx] = gc_state.position[idx] + pixel_count*pitch[idx]; }
+
+  if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
+    limits_soft_check(target);
+    if (sys.abort) { return(STATUS_OK); }
+  }
+
+  // Initialize planner data to the current spindle and coolant modal state.
+  plan_line_data_t plan_data;
+  memset(&plan_data,0,sizeof(plan_line_data_t));
+  plan_data.feed_rate = feed_rate;
+  // NOTE: As with g-code motions, the laser only powers in a G1, G2, G3, or G5 motion mode state.
+  if ((gc_state.modal.motion == MOTION_MODE_LINEAR) || (gc_state.modal.motion == MOTION_MODE_CW_ARC)
+      || (gc_state.modal.motion == MOTION_MODE_CCW_ARC) || gc_is_spline(gc_state.modal.motion)) {
+    plan_data.spindle_speed = gc_state.spindle_speed;
+  }
+  plan_data.condition = (gc_state.modal.spindle | gc_state.modal.coolant);
+  plan_data.raster_count = pixel_count;
+  #ifdef USE_LINE_NUMBERS
+    plan_data.line_number = gc_state.line_number;
+  #endif
+
+  #ifdef ENABLE_LAZY_ARCS
+    mc_arc_flush(); // Plan the rest of a pending arc, before this motion.
+  #endif
+
+  if (sys.state == STATE_CHECK_MODE) {
+    #ifdef ENABLE_CHECK_MODE_ESTIMATE
+      // Plan the scanline for the estimator, as in mc_line(). The pixels don't alter the motion
+      // timing and are not traced by the estimator, so they are not queued.
+      if (plan_check_full_buffer()) { st_estimate_execute(false); }
+      if (sys.abort) { return(STATUS_OK); } // Bail, if system abort.
+      if (plan_buffer_line(target, &plan_data) == PLAN_EMPTY_BLOCK) { return(STATUS_INVALID_STATEMENT); }
+    #endif
+  } else {
+    // Wait for room in both the planner and raster pixel buffers, as in mc_line().
+    do {
+      protocol_execute_realtime(); // Check for any run-time commands
+      if (sys.abort) { return(STATUS_OK); } // Bail, if system abort.
+      if (plan_check_full_buffer() || (raster_get_buffer_available() < pixel_count)) { protocol_auto_cycle_start(); }
+      else { break; }
+    } while (1);
+
+    // Bail if any pixel spans less than a step. Nothing has been queued.
+    if (plan_buffer_line(target, &plan_data) == PLAN_EMPTY_BLOCK) { return(STATUS_INVALID_STATEMENT); }
+
+    // Queue the pixel run. The segment generator is only called by the main program, so the
+    // stepper ISR can't begin tracing this block before its pixels are buffered.
+    for (idx=0; idx<pixel_count; idx++) {
+      raster_buffer[raster_buffer_head] = line[idx];
+      if (++raster_buffer_head == RASTER_BUFFER_SIZE) { raster_buffer_head = 0; }
+    }
+  }
+
+  memcpy(gc_state.position, target, sizeof(target)); // gc_state.position[] = target[];
+  return(STATUS_OK);
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+  raster.h - Laser raster scanline methods
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef raster_h
+#define raster_h
+
+// Size of the raster pixel ring buffer. Must hold at least one full '$L' scanline command.
+#ifndef RASTER_BUFFER_SIZE
+  #define RASTER_BUFFER_SIZE 128
+#endif
+
+// Clears the raster pixel buffer. Called by the system abort/initialization routine.
+void raster_reset();
+
+// Parses and executes a '$L' raster scanline command received from the protocol.
+uint8_t raster_execute_line(char *line);
+
+// Returns the next queued raster pixel power value. Called by the stepper ISR only.
+uint8_t raster_get_next_pixel();
+
+#endif
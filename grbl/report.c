@@ -28,6 +28,19 @@
 
 #include "grbl.h"
 
+#define REPORT_ITEM_END 0xff // Returned by report item printers past the last item.
+
+#ifdef ENABLE_CHUNKED_REPORTS
+  static uint8_t report_chunk_type;   // Active chunked report. REPORT_CHUNK_NONE, if none.
+  static uint8_t report_chunk_item;   // Next item index of the active chunked report.
+  static uint8_t report_chunk_status; // Deferred status of the command requesting the report.
+  static char *report_chunk_line;     // Build info line of a chunked build info report.
+  static uint8_t report_status_field; // Next field of a chunked status report. Zero, if none started.
+  static void report_realtime_status_finish();
+#else
+  #define report_realtime_status_finish()
+#endif
+
 
 // Internal report utilities to reduce flash with repetitive tasks turned into functions.
 void report_util_setting_prefix(uint8_t n) { serial_write('$'); print_uint8_base10(n); serial_write('='); }
@@ -44,6 +57,72 @@ static void report_util_axis_values(float *axis_value) {
   }
 }
 
+// Cached scale factors for converting axis steps directly to fixed-point position report values.
+static float report_step_scale[N_AXIS];  // Scaled report value per step for each axis.
+static float report_mm_scale;            // Scaled report value per mm.
+static float report_scale_steps_per_mm[N_AXIS]; // Steps/mm settings of the cached scale factors.
+static uint8_t report_scale_inches;      // Report inches setting of the cached scale factors.
+
+// Prints the axis positions of a step array, less an optional offset in mm, in the report units.
+// Each axis is converted to a fixed-point integer with one multiply by a cached reciprocal scale,
+// rather than a float division to mm and the multiplies of printFloat(). The scales are recomputed
+// only when the steps/mm or report inches settings change.
+static void report_util_position_values(int32_t *steps, float *offset) {
+  uint8_t idx;
+  uint8_t decimal_places = N_DECIMAL_COORDVALUE_MM;
+  uint8_t report_inches = bit_istrue(settings.flags,BITFLAG_REPORT_INCHES);
+  if (report_inches) { decimal_places = N_DECIMAL_COORDVALUE_INCH; }
+  if ((report_inches != report_scale_inches) ||
+      memcmp(report_scale_steps_per_mm,settings.steps_per_mm,sizeof(report_scale_steps_per_mm))) {
+    report_scale_inches = report_inches;
+    memcpy(report_scale_steps_per_mm,settings.steps_per_mm,sizeof(report_scale_steps_per_mm));
+    if (report_inches) { report_mm_scale = INCH_PER_MM; }
+    else { report_mm_scale = 1.0; }
+    for (idx=0; idx<decimal_places; idx++) { report_mm_scale *= 10; }
+    for (idx=0; idx<N_AXIS; idx++) { report_step_scale[idx] = report_mm_scale/settings.steps_per_mm[idx]; }
+  }
+  int32_t axis_steps;
+  float value;
+  for (idx=0; idx<N_AXIS; idx++) {
+    #ifdef COREXY
+      if (idx==X_AXIS) { axis_steps = system_convert_corexy_to_x_axis_steps(steps); }
+      else if (idx==Y_AXIS) { axis_steps = system_convert_corexy_to_y_axis_steps(steps); }
+      else { axis_steps = steps[idx]; }
+    #else
+      axis_steps = steps[idx];
+    #endif
+    value = axis_steps*report_step_scale[idx];
+    if (offset) { value -= offset[idx]*report_mm_scale; }
+    if (value < 0) {
+      serial_write('-');
+      value = -value;
+    }
+    print_uint32_fixed((long)(value+0.5),decimal_places); // Round to the last decimal place.
+    if (idx < (N_AXIS-1)) { serial_write(','); }
+  }
+}
+
+#ifdef ENABLE_COMPACT_STATUS_REPORT
+static void report_util_axis_steps(int32_t *axis_steps) {
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    printInteger(axis_steps[idx]);
+    if (idx < (N_AXIS-1)) { serial_write(','); }
+  }
+}
+
+// Last reported values for compact status reports, which only send fields that have changed.
+static int32_t compact_position[N_AXIS];
+static float compact_feed_rate;
+static float compact_spindle_speed;
+static uint16_t compact_pin_state;
+static uint8_t compact_plan_available;
+static uint8_t compact_rx_available;
+#ifdef USE_LINE_NUMBERS
+static uint32_t compact_line_number;
+#endif
+#endif
+
 /*
 static void report_util_setting_string(uint8_t n) {
   serial_write(' ');
@@ -111,6 +190,14 @@ static void report_util_float_setting(uint8_t n, float val, uint8_t n_decimal) {
 // responses.
 void report_status_message(uint8_t status_code)
 {
+  report_realtime_status_finish();
+  #ifdef ENABLE_CHUNKED_REPORTS
+    // Hold the status of a command that started a chunked report until the report is complete.
+    if (report_chunk_type != REPORT_CHUNK_NONE) {
+      report_chunk_status = status_code;
+      return;
+    }
+  #endif
   switch(status_code) {
     case STATUS_OK: // STATUS_OK
       printPgmString(PSTR("ok\r\n")); break;
@@ -124,6 +211,7 @@ void report_status_message(uint8_t status_code)
 // Prints alarm messages.
 void report_alarm_message(uint8_t alarm_code)
 {
+  report_realtime_status_finish();
   printPgmString(PSTR("ALARM:"));
   print_uint8_base10(alarm_code);
   report_util_line_feed();
@@ -137,6 +225,7 @@ void report_alarm_message(uint8_t alarm_code)
 // is installed, the message number codes are less than zero.
 void report_feedback_message(uint8_t message_code)
 {
+  report_realtime_status_finish();
   printPgmString(PSTR("[MSG:"));
   switch(message_code) {
     case MESSAGE_CRITICAL_EVENT:
@@ -178,50 +267,79 @@ void report_grbl_help() {
 }
 
 
-// Grbl global settings print out.
+// Item indices of the global settings. The optional settings follow the last item of every build,
+// and the axis settings follow the last global setting item.
+#define REPORT_SETTING_ITEM_LASER_MODE 21 // $32, the last item of every build
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  #define REPORT_SETTING_ITEM_AUTO_REPORT (REPORT_SETTING_ITEM_LASER_MODE+1) // $33
+  #define REPORT_SETTING_ITEM_LAST REPORT_SETTING_ITEM_AUTO_REPORT
+#else
+  #define REPORT_SETTING_ITEM_LAST REPORT_SETTING_ITEM_LASER_MODE
+#endif
+#define REPORT_GLOBAL_SETTINGS_COUNT (REPORT_SETTING_ITEM_LAST+1)
+
+// Grbl global settings print out. Prints the global setting line of the given item index.
+// Returns REPORT_ITEM_END, if past the last global setting.
 // NOTE: The numbering scheme here must correlate to storing in settings.c
-void report_grbl_settings() {
-  // Print Grbl settings.
-  report_util_uint8_setting(0,settings.pulse_microseconds);
-  report_util_uint8_setting(1,settings.stepper_idle_lock_time);
-  report_util_uint8_setting(2,settings.step_invert_mask);
-  report_util_uint8_setting(3,settings.dir_invert_mask);
-  report_util_uint8_setting(4,bit_istrue(settings.flags,BITFLAG_INVERT_ST_ENABLE));
-  report_util_uint8_setting(5,bit_istrue(settings.flags,BITFLAG_INVERT_LIMIT_PINS));
-  report_util_uint8_setting(6,bit_istrue(settings.flags,BITFLAG_INVERT_PROBE_PIN));
-  report_util_uint8_setting(10,settings.status_report_mask);
-  report_util_float_setting(11,settings.junction_deviation,N_DECIMAL_SETTINGVALUE);
-  report_util_float_setting(12,settings.arc_tolerance,N_DECIMAL_SETTINGVALUE);
-  report_util_uint8_setting(13,bit_istrue(settings.flags,BITFLAG_REPORT_INCHES));
-  report_util_uint8_setting(20,bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE));
-  report_util_uint8_setting(21,bit_istrue(settings.flags,BITFLAG_HARD_LIMIT_ENABLE));
-  report_util_uint8_setting(22,bit_istrue(settings.flags,BITFLAG_HOMING_ENABLE));
-  report_util_uint8_setting(23,settings.homing_dir_mask);
-  report_util_float_setting(24,settings.homing_feed_rate,N_DECIMAL_SETTINGVALUE);
-  report_util_float_setting(25,settings.homing_seek_rate,N_DECIMAL_SETTINGVALUE);
-  report_util_uint8_setting(26,settings.homing_debounce_delay);
-  report_util_float_setting(27,settings.homing_pulloff,N_DECIMAL_SETTINGVALUE);
-  report_util_float_setting(30,settings.rpm_max,N_DECIMAL_RPMVALUE);
-  report_util_float_setting(31,settings.rpm_min,N_DECIMAL_RPMVALUE);
-  #ifdef VARIABLE_SPINDLE
-    report_util_uint8_setting(32,bit_istrue(settings.flags,BITFLAG_LASER_MODE));
-  #else
-    report_util_uint8_setting(32,0);
-  #endif
+static uint8_t report_grbl_global_settings_item(uint8_t item) {
+  switch (item) {
+    case 0: report_util_uint8_setting(0,settings.pulse_microseconds); break;
+    case 1: report_util_uint8_setting(1,settings.stepper_idle_lock_time); break;
+    case 2: report_util_uint8_setting(2,settings.step_invert_mask); break;
+    case 3: report_util_uint8_setting(3,settings.dir_invert_mask); break;
+    case 4: report_util_uint8_setting(4,bit_istrue(settings.flags,BITFLAG_INVERT_ST_ENABLE)); break;
+    case 5: report_util_uint8_setting(5,bit_istrue(settings.flags,BITFLAG_INVERT_LIMIT_PINS)); break;
+    case 6: report_util_uint8_setting(6,bit_istrue(settings.flags,BITFLAG_INVERT_PROBE_PIN)); break;
+    case 7: report_util_uint8_setting(10,settings.status_report_mask); break;
+    case 8: report_util_float_setting(11,settings.junction_deviation,N_DECIMAL_SETTINGVALUE); break;
+    case 9: report_util_float_setting(12,settings.arc_tolerance,N_DECIMAL_SETTINGVALUE); break;
+    case 10: report_util_uint8_setting(13,bit_istrue(settings.flags,BITFLAG_REPORT_INCHES)); break;
+    case 11: report_util_uint8_setting(20,bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)); break;
+    case 12: report_util_uint8_setting(21,bit_istrue(settings.flags,BITFLAG_HARD_LIMIT_ENABLE)); break;
+    case 13: report_util_uint8_setting(22,bit_istrue(settings.flags,BITFLAG_HOMING_ENABLE)); break;
+    case 14: report_util_uint8_setting(23,settings.homing_dir_mask); break;
+    case 15: report_util_float_setting(24,settings.homing_feed_rate,N_DECIMAL_SETTINGVALUE); break;
+    case 16: report_util_float_setting(25,settings.homing_seek_rate,N_DECIMAL_SETTINGVALUE); break;
+    case 17: report_util_uint8_setting(26,settings.homing_debounce_delay); break;
+    case 18: report_util_float_setting(27,settings.homing_pulloff,N_DECIMAL_SETTINGVALUE); break;
+    case 19: report_util_float_setting(30,settings.rpm_max,N_DECIMAL_RPMVALUE); break;
+    case 20: report_util_float_setting(31,settings.rpm_min,N_DECIMAL_RPMVALUE); break;
+    #ifdef VARIABLE_SPINDLE
+      case REPORT_SETTING_ITEM_LASER_MODE: report_util_uint8_setting(32,bit_istrue(settings.flags,BITFLAG_LASER_MODE)); break;
+    #else
+      case REPORT_SETTING_ITEM_LASER_MODE: report_util_uint8_setting(32,0); break;
+    #endif
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      case REPORT_SETTING_ITEM_AUTO_REPORT: report_util_float_setting(33,settings.status_report_interval,0); break;
+    #endif
+    default: return(REPORT_ITEM_END);
+  }
+  return(STATUS_OK);
+}
+
+
+// Prints the setting line of the given item index, one per global or axis setting, in that order.
+// Returns REPORT_ITEM_END, if past the last setting.
+static uint8_t report_grbl_settings_item(uint8_t item) {
+  if (item < REPORT_GLOBAL_SETTINGS_COUNT) { return(report_grbl_global_settings_item(item)); }
   // Print axis settings
-  uint8_t idx, set_idx;
-  uint8_t val = AXIS_SETTINGS_START_VAL;
-  for (set_idx=0; set_idx<AXIS_N_SETTINGS; set_idx++) {
-    for (idx=0; idx<N_AXIS; idx++) {
-      switch (set_idx) {
-        case 0: report_util_float_setting(val+idx,settings.steps_per_mm[idx],N_DECIMAL_SETTINGVALUE); break;
-        case 1: report_util_float_setting(val+idx,settings.max_rate[idx],N_DECIMAL_SETTINGVALUE); break;
-        case 2: report_util_float_setting(val+idx,settings.acceleration[idx]/(60*60),N_DECIMAL_SETTINGVALUE); break;
-        case 3: report_util_float_setting(val+idx,-settings.max_travel[idx],N_DECIMAL_SETTINGVALUE); break;
-      }
-    }
-    val += AXIS_SETTINGS_INCREMENT;
+  item -= REPORT_GLOBAL_SETTINGS_COUNT;
+  if (item >= (AXIS_N_SETTINGS*N_AXIS)) { return(REPORT_ITEM_END); }
+  uint8_t set_idx = item/N_AXIS;
+  uint8_t idx = item-set_idx*N_AXIS;
+  uint8_t val = AXIS_SETTINGS_START_VAL+set_idx*AXIS_SETTINGS_INCREMENT+idx;
+  switch (set_idx) {
+    case 0: report_util_float_setting(val,settings.steps_per_mm[idx],N_DECIMAL_SETTINGVALUE); break;
+    case 1: report_util_float_setting(val,settings.max_rate[idx],N_DECIMAL_SETTINGVALUE); break;
+    case 2: report_util_float_setting(val,settings.acceleration[idx]/(60*60),N_DECIMAL_SETTINGVALUE); break;
+    case 3: report_util_float_setting(val,-settings.max_travel[idx],N_DECIMAL_SETTINGVALUE); break;
   }
+  return(STATUS_OK);
+}
+
+void report_grbl_settings() {
+  uint8_t item = 0;
+  while (report_grbl_settings_item(item++) == STATUS_OK) {}
 }
 
 
@@ -230,6 +348,7 @@ void report_grbl_settings() {
 // These values are retained until Grbl is power-cycled, whereby they will be re-zeroed.
 void report_probe_parameters()
 {
+  report_realtime_status_finish();
   // Report in terms of machine position.
   printPgmString(PSTR("[PRB:"));
   float print_position[N_AXIS];
@@ -241,33 +360,73 @@ void report_probe_parameters()
 }
 
 
-// Prints Grbl NGC parameters (coordinate offsets, probing)
-void report_ngc_parameters()
+#ifdef ENABLE_PROGRAM_STORAGE
+  void report_storage_program(uint8_t program, uint32_t size)
+  {
+    report_realtime_status_finish();
+    printPgmString(PSTR("[PRG:"));
+    print_uint8_base10(program);
+    serial_write(',');
+    print_uint32_base10(size);
+    report_util_feedback_line_feed();
+  }
+
+
+  void report_storage_run_end(uint8_t program, uint32_t line_number, uint8_t status_code)
+  {
+    report_realtime_status_finish();
+    printPgmString(PSTR("[RUN:"));
+    print_uint8_base10(program);
+    serial_write(',');
+    print_uint32_base10(line_number);
+    serial_write(':');
+    print_uint8_base10(status_code);
+    report_util_feedback_line_feed();
+  }
+#endif
+
+
+// Prints Grbl NGC parameters (coordinate offsets, probing). Prints the parameter line of the given
+// item index. Returns REPORT_ITEM_END, if past the last parameter, or an EEPROM read failure status.
+static uint8_t report_ngc_parameters_item(uint8_t item)
 {
-  float coord_data[N_AXIS];
-  uint8_t coord_select;
-  for (coord_select = 0; coord_select <= SETTING_INDEX_NCOORD; coord_select++) {
-    if (!(settings_read_coord_data(coord_select,coord_data))) {
-      report_status_message(STATUS_SETTING_READ_FAIL);
-      return;
-    }
+  if (item <= SETTING_INDEX_NCOORD) {
+    float coord_data[N_AXIS];
+    if (!(settings_read_coord_data(item,coord_data))) { return(STATUS_SETTING_READ_FAIL); }
     printPgmString(PSTR("[G"));
-    switch (coord_select) {
+    switch (item) {
       case 6: printPgmString(PSTR("28")); break;
       case 7: printPgmString(PSTR("30")); break;
-      default: print_uint8_base10(coord_select+54); break; // G54-G59
+      default: print_uint8_base10(item+54); break; // G54-G59
     }
     serial_write(':');
     report_util_axis_values(coord_data);
     report_util_feedback_line_feed();
+  } else {
+    switch (item-SETTING_INDEX_NCOORD) {
+      case 1:
+        printPgmString(PSTR("[G92:")); // Print G92,G92.1 which are not persistent in memory
+        report_util_axis_values(gc_state.coord_offset);
+        report_util_feedback_line_feed();
+        break;
+      case 2:
+        printPgmString(PSTR("[TLO:")); // Print tool length offset value
+        printFloat_CoordValue(gc_state.tool_length_offset);
+        report_util_feedback_line_feed();
+        break;
+      case 3: report_probe_parameters(); break; // Print probe parameters. Not persistent in memory.
+      default: return(REPORT_ITEM_END);
+    }
   }
-  printPgmString(PSTR("[G92:")); // Print G92,G92.1 which are not persistent in memory
-  report_util_axis_values(gc_state.coord_offset);
-  report_util_feedback_line_feed();
-  printPgmString(PSTR("[TLO:")); // Print tool length offset value
-  printFloat_CoordValue(gc_state.tool_length_offset);
-  report_util_feedback_line_feed();
-  report_probe_parameters(); // Print probe parameters. Not persistent in memory.
+  return(STATUS_OK);
+}
+
+void report_ngc_parameters()
+{
+  uint8_t item = 0;
+  uint8_t status;
+  while ((status = report_ngc_parameters_item(item++)) == STATUS_OK) {}
+  if (status != REPORT_ITEM_END) { report_status_message(status); }
 }
 
 
@@ -278,6 +437,10 @@ void report_gcode_modes()
   if (gc_state.modal.motion >= MOTION_MODE_PROBE_TOWARD) {
     printPgmString(PSTR("38."));
     print_uint8_base10(gc_state.modal.motion - (MOTION_MODE_PROBE_TOWARD-2));
+  #ifdef ENABLE_SPLINES
+  } else if (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE) {
+    printPgmString(PSTR("5.1"));
+  #endif
   } else {
     print_uint8_base10(gc_state.modal.motion);
   }
@@ -297,6 +460,11 @@ void report_gcode_modes()
   report_util_gcode_modes_G();
   print_uint8_base10(94-gc_state.modal.feed_rate);
 
+  #ifdef ENABLE_CANNED_CYCLES
+    report_util_gcode_modes_G();
+    print_uint8_base10(98+gc_state.modal.retract);
+  #endif
+
   if (gc_state.modal.program_flow) {
     report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
@@ -360,18 +528,24 @@ void report_startup_line(uint8_t n, char *line)
 
 void report_execute_startup_message(char *line, uint8_t status_code)
 {
+  report_realtime_status_finish();
   serial_write('>');
   printString(line);
   serial_write(':');
   report_status_message(status_code);
 }
 
-// Prints build info line
-void report_build_info(char *line)
+// Prints build info line of the given item index, the version and user info line and then the
+// build option line. Returns REPORT_ITEM_END, if past the last line.
+static uint8_t report_build_info_item(uint8_t item, char *line)
 {
-  printPgmString(PSTR("[VER:" GRBL_VERSION "." GRBL_VERSION_BUILD ":"));
-  printString(line);
-  report_util_feedback_line_feed();
+  if (item == 0) {
+    printPgmString(PSTR("[VER:" GRBL_VERSION "." GRBL_VERSION_BUILD ":"));
+    printString(line);
+    report_util_feedback_line_feed();
+    return(STATUS_OK);
+  }
+  if (item > 1) { return(REPORT_ITEM_END); }
   printPgmString(PSTR("[OPT:")); // Generate compile-time build option list
   #ifdef VARIABLE_SPINDLE
     serial_write('V');
@@ -446,214 +620,621 @@ void report_build_info(char *line)
   print_uint8_base10(RX_BUFFER_SIZE);
 
   report_util_feedback_line_feed();
+  return(STATUS_OK);
+}
+
+void report_build_info(char *line)
+{
+  uint8_t item = 0;
+  while (report_build_info_item(item++,line) == STATUS_OK) {}
 }
 
 
+#ifdef ENABLE_PERF_COUNTERS
+  // Prints performance counter line of the given item index. Each timer line holds the call count
+  // and the average and max call times in microseconds, followed by a line of the main program
+  // counts and a line of the event counters.
+  // Returns REPORT_ITEM_END, if past the last line.
+  static uint8_t report_perf_counters_item(uint8_t item)
+  {
+    if (item > N_PERF_TIMER+1) { return(REPORT_ITEM_END); }
+    printPgmString(PSTR("[PRF:"));
+    if (item < N_PERF_TIMER) {
+      switch (item) {
+        case PERF_TIMER_GC_EXECUTE: printPgmString(PSTR("GC")); break;
+        case PERF_TIMER_PLAN_BUFFER: printPgmString(PSTR("PLAN")); break;
+        case PERF_TIMER_PLAN_RECALCULATE: printPgmString(PSTR("RECALC")); break;
+        case PERF_TIMER_ST_PREP: printPgmString(PSTR("PREP")); break;
+        case PERF_TIMER_MC_ARC: printPgmString(PSTR("ARC")); break;
+        case PERF_TIMER_STATUS_REPORT: printPgmString(PSTR("RPT")); break;
+        case PERF_TIMER_PLANNER_FULL: printPgmString(PSTR("WAIT")); break;
+      }
+      perf_timer_t *pt = &perf_timer[item];
+      serial_write(':');
+      print_uint32_base10(pt->count);
+      serial_write(',');
+      if (pt->count) { print_uint32_base10((pt->total*PERF_US_PER_TICK)/pt->count); }
+      else { serial_write('0'); }
+      serial_write(',');
+      print_uint32_base10(pt->max*PERF_US_PER_TICK);
+    } else if (item == N_PERF_TIMER) {
+      printPgmString(PSTR("SEG:"));
+      print_uint32_base10(perf_count[PERF_COUNT_SEGMENT]);
+      printPgmString(PSTR(",RCB:"));
+      print_uint32_base10(perf_count[PERF_COUNT_RECALC_BLOCK]);
+    } else {
+      uint16_t event_count[N_PERF_EVENT];
+      uint8_t sreg = SREG;
+      cli();
+      memcpy(event_count,(void*)perf_event,sizeof(event_count)); // Counted by interrupts.
+      SREG = sreg;
+      printPgmString(PSTR("RXO:"));
+      print_uint32_base10(event_count[PERF_EVENT_RX_OVERFLOW]);
+      printPgmString(PSTR(",UND:"));
+      print_uint32_base10(event_count[PERF_EVENT_SEGMENT_UNDERRUN]);
+    }
+    report_util_feedback_line_feed();
+    return(STATUS_OK);
+  }
+
+  void report_perf_counters()
+  {
+    uint8_t item = 0;
+    while (report_perf_counters_item(item++) == STATUS_OK) {}
+  }
+#endif
+
+
+#ifdef ENABLE_CHECK_MODE_ESTIMATE
+  void report_estimate_total(float seconds)
+  {
+    report_realtime_status_finish();
+    printPgmString(PSTR("[EST:"));
+    printFloat(seconds,N_DECIMAL_ESTIMATE);
+    report_util_feedback_line_feed();
+  }
+
+  #ifdef USE_LINE_NUMBERS
+    void report_estimate_line(int32_t line_number, float seconds)
+    {
+      report_realtime_status_finish();
+      printPgmString(PSTR("[EST:N"));
+      printInteger(line_number);
+      serial_write(',');
+      printFloat(seconds,N_DECIMAL_ESTIMATE);
+      report_util_feedback_line_feed();
+    }
+  #endif
+#endif
+
+
+#ifdef ENABLE_MOTION_TRACE
+  // Prints motion trace record line of the given item index, oldest first, as fixed-width hex
+  // fields for compact logging: timestamp (8), stepper block index (2), step events (4), cycles
+  // per tick (4), AMASS level or prescaler (2), and line number (8), if enabled. Returns
+  // REPORT_ITEM_END, if past the last record.
+  static uint8_t report_motion_trace_item(uint8_t item)
+  {
+    st_trace_t record;
+    if (!st_get_trace_record(item,&record)) { return(REPORT_ITEM_END); }
+    printPgmString(PSTR("[TRC:"));
+    print_uint32_base16_ndigit(record.timestamp,8);
+    print_uint32_base16_ndigit(record.st_block_index,2);
+    print_uint32_base16_ndigit(record.n_step,4);
+    print_uint32_base16_ndigit(record.cycles_per_tick,4);
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      print_uint32_base16_ndigit(record.amass_level,2);
+    #else
+      print_uint32_base16_ndigit(record.prescaler,2);
+    #endif
+    #ifdef USE_LINE_NUMBERS
+      print_uint32_base16_ndigit(record.line_number,8);
+    #endif
+    report_util_feedback_line_feed();
+    return(STATUS_OK);
+  }
+
+  void report_motion_trace()
+  {
+    uint8_t item = 0;
+    while (report_motion_trace_item(item++) == STATUS_OK) {}
+  }
+#endif
+
+
+#ifdef ENABLE_CHUNKED_REPORTS
+  void report_chunked_start(uint8_t type, char *line)
+  {
+    report_chunk_type = type;
+    report_chunk_item = 0;
+    report_chunk_status = STATUS_OK;
+    report_chunk_line = line;
+  }
+
+
+  void report_chunked_reset()
+  {
+    report_chunk_type = REPORT_CHUNK_NONE;
+    report_status_field = 0;
+  }
+
+
+  uint8_t report_chunked_continue()
+  {
+    if (report_status_field) { return(true); } // Hold off command responses until the status report is complete.
+    if (report_chunk_type == REPORT_CHUNK_NONE) { return(false); }
+    uint8_t status;
+    while (serial_get_tx_buffer_available() >= REPORT_CHUNK_TX_MIN_FREE) {
+      // Give way to pending status reports, which are deferred while the TX buffer is filling.
+      if (sys_rt_exec_state & EXEC_STATUS_REPORT) { break; }
+      #ifdef ENABLE_AUTO_STATUS_REPORT
+        if (report_auto_pending) { break; }
+      #endif
+      switch (report_chunk_type) {
+        case REPORT_CHUNK_SETTINGS: status = report_grbl_settings_item(report_chunk_item); break;
+        case REPORT_CHUNK_NGC_PARAMETERS: status = report_ngc_parameters_item(report_chunk_item); break;
+        #ifdef ENABLE_PERF_COUNTERS
+          case REPORT_CHUNK_PERF_COUNTERS: status = report_perf_counters_item(report_chunk_item); break;
+        #endif
+        #ifdef ENABLE_MOTION_TRACE
+          case REPORT_CHUNK_MOTION_TRACE: status = report_motion_trace_item(report_chunk_item); break;
+        #endif
+        default: status = report_build_info_item(report_chunk_item,report_chunk_line); break;
+      }
+      report_chunk_item++;
+      if (status != STATUS_OK) {
+        // Report complete or failed. Print any failure and then the deferred command status.
+        report_chunk_type = REPORT_CHUNK_NONE;
+        if (status != REPORT_ITEM_END) { report_status_message(status); }
+        report_status_message(report_chunk_status);
+        return(false);
+      }
+    }
+    return(true);
+  }
+#endif
+
+
 // Prints the character string line Grbl has received from the user, which has been pre-parsed,
 // and has been sent into protocol_execute_line() routine to be executed by Grbl.
 void report_echo_line_received(char *line)
 {
+  report_realtime_status_finish();
   printPgmString(PSTR("[echo: ")); printString(line);
   report_util_feedback_line_feed();
 }
 
 
- // Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
- // and the actual location of the CNC machine. Users may change the following function to their
- // specific needs, but the desired real-time data report must be as short as possible. This is
- // requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
- // especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-void report_realtime_status()
-{
-  uint8_t idx;
-  int32_t current_position[N_AXIS]; // Copy current state of the system position variable
-  memcpy(current_position,sys_position,sizeof(sys_position));
-  float print_position[N_AXIS];
-  system_convert_array_steps_to_mpos(print_position,current_position);
-
-  // Report current machine state and sub-states
-  serial_write('<');
-  switch (sys.state) {
-    case STATE_IDLE: printPgmString(PSTR("Idle")); break;
-    case STATE_CYCLE: printPgmString(PSTR("Run")); break;
-    case STATE_HOLD:
-      if (!(sys.suspend & SUSPEND_JOG_CANCEL)) {
-        printPgmString(PSTR("Hold:"));
-        if (sys.suspend & SUSPEND_HOLD_COMPLETE) { serial_write('0'); } // Ready to resume
-        else { serial_write('1'); } // Actively holding
-        break;
-      } // Continues to print jog state during jog cancel.
-    case STATE_JOG: printPgmString(PSTR("Jog")); break;
-    case STATE_HOMING: printPgmString(PSTR("Home")); break;
-    case STATE_ALARM: printPgmString(PSTR("Alarm")); break;
-    case STATE_CHECK_MODE: printPgmString(PSTR("Check")); break;
-    case STATE_SAFETY_DOOR:
-      printPgmString(PSTR("Door:"));
-      if (sys.suspend & SUSPEND_INITIATE_RESTORE) {
-        serial_write('3'); // Restoring
-      } else {
-        if (sys.suspend & SUSPEND_RETRACT_COMPLETE) {
-          if (sys.suspend & SUSPEND_SAFETY_DOOR_AJAR) {
-            serial_write('1'); // Door ajar
-          } else {
-            serial_write('0');
-          } // Door closed and ready to resume
-        } else {
-          serial_write('2'); // Retracting
-        }
-      }
-      break;
-    case STATE_SLEEP: printPgmString(PSTR("Sleep")); break;
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  // The auto report interval is timed with the Timer2 compare B interrupt, which fires once every
+  // 256 timer counts in both fast PWM and normal modes, independent of the spindle PWM output.
+  #define AUTO_REPORT_TICKS_PER_MS (F_CPU/(1000.0*256*SPINDLE_TIMER_PRESCALER))
+
+  volatile uint8_t report_auto_pending;
+  static uint16_t auto_report_ticks;     // Timer ticks remaining until the next auto report.
+  static uint16_t auto_report_interval;  // Auto report interval in timer ticks.
+  static uint8_t auto_report_state;      // Machine state at the last changes-only auto report.
+  static int32_t auto_report_position[N_AXIS]; // Machine position at the last changes-only auto report.
+
+
+  void report_auto_init()
+  {
+    SPINDLE_TIMSK_REGISTER &= ~(1<<SPINDLE_OCIEB_BIT); // Stop report timer.
+    report_auto_pending = false;
+    auto_report_state = 0xff; // Not a valid state. Forces the first changes-only report.
+    if (settings.status_report_interval == 0) { return; }
+    #ifndef VARIABLE_SPINDLE
+      SPINDLE_TCCRA_REGISTER = 0; // Normal mode
+      SPINDLE_TCCRB_REGISTER = SPINDLE_TIMER_CS;
+    #endif
+    auto_report_interval = min(ceil(settings.status_report_interval*AUTO_REPORT_TICKS_PER_MS),0xffff);
+    auto_report_ticks = auto_report_interval;
+    SPINDLE_TIMSK_REGISTER |= (1<<SPINDLE_OCIEB_BIT); // Start report timer.
   }
 
-  float wco[N_AXIS];
-  if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE) ||
-      (sys.report_wco_counter == 0) ) {
-    for (idx=0; idx< N_AXIS; idx++) {
-      // Apply work coordinate offsets and tool length offset to current position.
-      wco[idx] = gc_state.coord_system[idx]+gc_state.coord_offset[idx];
-      if (idx == TOOL_LENGTH_OFFSET_AXIS) { wco[idx] += gc_state.tool_length_offset; }
-      if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
-        print_position[idx] -= wco[idx];
-      }
+
+  // Auto report timer tick. Flags the main program when the report interval has elapsed.
+  ISR(SPINDLE_TIMER_COMPB_vect)
+  {
+    if (--auto_report_ticks == 0) {
+      auto_report_ticks = auto_report_interval;
+      report_auto_pending = true;
     }
   }
 
-  // Report machine position
-  if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
-    printPgmString(PSTR("|MPos:"));
-  } else {
-    printPgmString(PSTR("|WPos:"));
-  }
-  report_util_axis_values(print_position);
 
-  // Returns planner and serial read buffer states.
-  #ifdef REPORT_FIELD_BUFFER_STATE
-    if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_BUFFER_STATE)) {
-      printPgmString(PSTR("|Bf:"));
-      print_uint8_base10(plan_get_block_buffer_available());
-      serial_write(',');
-      print_uint8_base10(serial_get_rx_buffer_available());
+  // Called by the realtime protocol when an auto report is due. Sends a status report, unless set
+  // to report changes only and the state, position, override values, and work offset are unchanged.
+  void report_auto_status()
+  {
+    #ifdef ENABLE_CHUNKED_REPORTS
+      // Finish a status report in progress before checking for changes. It counts as the auto report.
+      if (report_status_field) {
+        if (report_realtime_status_continue()) { report_auto_pending = false; }
+        return;
+      }
+    #endif
+    if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_AUTO_ON_CHANGE)) {
+      if ((sys.state == auto_report_state) && sys.report_ovr_counter && sys.report_wco_counter &&
+          (memcmp(sys_position, auto_report_position, sizeof(sys_position)) == 0)) {
+        report_auto_pending = false;
+        return;
+      }
+      auto_report_state = sys.state;
+      memcpy(auto_report_position, sys_position, sizeof(sys_position));
     }
-  #endif
+    #ifdef ENABLE_CHUNKED_REPORTS
+      if (!report_realtime_status_continue()) { return; } // Continued while the TX buffer has room.
+    #else
+      report_realtime_status();
+    #endif
+    report_auto_pending = false;
+  }
+#endif
 
-  #ifdef USE_LINE_NUMBERS
-    #ifdef REPORT_FIELD_LINE_NUMBERS
-      // Report current line number
-      plan_block_t * cur_block = plan_get_current_block();
-      if (cur_block != NULL) {
-        uint32_t ln = cur_block->line_number;
-        if (ln > 0) {
-          printPgmString(PSTR("|Ln:"));
-          printInteger(ln);
+
+// Define status report fields, printed in this order. Each is printed whole, so that a chunked status
+// report may pause between any two fields.
+#define REPORT_STATUS_FIELD_STATE     0 // Takes the report snapshot. Machine state and sub-states.
+#define REPORT_STATUS_FIELD_POSITION  1
+#define REPORT_STATUS_FIELD_BUFFER    2
+#define REPORT_STATUS_FIELD_LINE      3
+#define REPORT_STATUS_FIELD_RUN       4
+#define REPORT_STATUS_FIELD_FEED      5
+#define REPORT_STATUS_FIELD_PINS      6
+#define REPORT_STATUS_FIELD_WCO       7
+#define REPORT_STATUS_FIELD_OVERRIDES 8
+#define REPORT_STATUS_FIELD_END       9
+
+// Status report snapshot, shared by the fields of one report.
+static int32_t report_status_position[N_AXIS]; // Copy of the system position at the report start.
+static float report_status_wco[N_AXIS];        // Work coordinate offset, if reported.
+#ifdef ENABLE_COMPACT_STATUS_REPORT
+  static uint8_t report_status_compact;        // Compact report mode.
+  static uint8_t report_status_all;            // Compact keyframe with every field.
+#endif
+
+
+// Prints one field of the real-time status report.
+static void report_realtime_status_field(uint8_t field)
+{
+  uint8_t idx;
+  switch (field) {
+    case REPORT_STATUS_FIELD_STATE:
+      memcpy(report_status_position,sys_position,sizeof(sys_position)); // Copy current state of the system position variable
+
+      #ifdef ENABLE_COMPACT_STATUS_REPORT
+        // In compact mode, send every field only with the periodic work coordinate offset refresh.
+        report_status_compact = bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_COMPACT);
+        report_status_all = (!report_status_compact || (sys.report_wco_counter == 0));
+      #endif
+
+      if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE) ||
+          (sys.report_wco_counter == 0) ) {
+        for (idx=0; idx< N_AXIS; idx++) {
+          // Compute work coordinate offsets and tool length offset to apply to current position.
+          report_status_wco[idx] = gc_state.coord_system[idx]+gc_state.coord_offset[idx];
+          if (idx == TOOL_LENGTH_OFFSET_AXIS) { report_status_wco[idx] += gc_state.tool_length_offset; }
         }
       }
-    #endif
-  #endif
 
-  // Report realtime feed speed
-  #ifdef REPORT_FIELD_CURRENT_FEED_SPEED
-    #ifdef VARIABLE_SPINDLE
-      printPgmString(PSTR("|FS:"));
-      printFloat_RateValue(st_get_realtime_rate());
-      serial_write(',');
-      printFloat(sys.spindle_speed,N_DECIMAL_RPMVALUE);
-    #else
-      printPgmString(PSTR("|F:"));
-      printFloat_RateValue(st_get_realtime_rate());
-    #endif      
-  #endif
+      // Report current machine state and sub-states
+      serial_write('<');
+      switch (sys.state) {
+        case STATE_IDLE: printPgmString(PSTR("Idle")); break;
+        case STATE_CYCLE: printPgmString(PSTR("Run")); break;
+        case STATE_HOLD:
+          if (!(sys.suspend & SUSPEND_JOG_CANCEL)) {
+            printPgmString(PSTR("Hold:"));
+            if (sys.suspend & SUSPEND_HOLD_COMPLETE) { serial_write('0'); } // Ready to resume
+            else { serial_write('1'); } // Actively holding
+            break;
+          } // Continues to print jog state during jog cancel.
+        case STATE_JOG: printPgmString(PSTR("Jog")); break;
+        case STATE_HOMING: printPgmString(PSTR("Home")); break;
+        case STATE_ALARM: printPgmString(PSTR("Alarm")); break;
+        case STATE_CHECK_MODE: printPgmString(PSTR("Check")); break;
+        case STATE_SAFETY_DOOR:
+          printPgmString(PSTR("Door:"));
+          if (sys.suspend & SUSPEND_INITIATE_RESTORE) {
+            serial_write('3'); // Restoring
+          } else {
+            if (sys.suspend & SUSPEND_RETRACT_COMPLETE) {
+              if (sys.suspend & SUSPEND_SAFETY_DOOR_AJAR) {
+                serial_write('1'); // Door ajar
+              } else {
+                serial_write('0');
+              } // Door closed and ready to resume
+            } else {
+              serial_write('2'); // Retracting
+            }
+          }
+          break;
+        case STATE_SLEEP: printPgmString(PSTR("Sleep")); break;
+      }
+      break;
 
-  #ifdef REPORT_FIELD_PIN_STATE
-    uint8_t lim_pin_state = limits_get_state();
-    uint8_t ctrl_pin_state = system_control_get_state();
-    uint8_t prb_pin_state = probe_get_state();
-    if (lim_pin_state | ctrl_pin_state | prb_pin_state) {
-      printPgmString(PSTR("|Pn:"));
-      if (prb_pin_state) { serial_write('P'); }
-      if (lim_pin_state) {
-        #ifdef ENABLE_DUAL_AXIS
-          #if (DUAL_AXIS_SELECT == X_AXIS)
-            if (bit_istrue(lim_pin_state,(bit(X_AXIS)|bit(N_AXIS)))) { serial_write('X'); }
-            if (bit_istrue(lim_pin_state,bit(Y_AXIS))) { serial_write('Y'); }
-          #endif
-          #if (DUAL_AXIS_SELECT == Y_AXIS)
-            if (bit_istrue(lim_pin_state,bit(X_AXIS))) { serial_write('X'); }
-            if (bit_istrue(lim_pin_state,(bit(Y_AXIS)|bit(N_AXIS)))) { serial_write('Y'); }
-          #endif
-          if (bit_istrue(lim_pin_state,bit(Z_AXIS))) { serial_write('Z'); }
-        #else
-          if (bit_istrue(lim_pin_state,bit(X_AXIS))) { serial_write('X'); }
-          if (bit_istrue(lim_pin_state,bit(Y_AXIS))) { serial_write('Y'); }
-          if (bit_istrue(lim_pin_state,bit(Z_AXIS))) { serial_write('Z'); }
-        #endif
+    case REPORT_STATUS_FIELD_POSITION:
+      #ifdef ENABLE_COMPACT_STATUS_REPORT
+      if (report_status_compact) {
+        // Report absolute machine position in steps with a keyframe, otherwise the change in steps.
+        if (report_status_all) {
+          printPgmString(PSTR("|MS:"));
+          report_util_axis_steps(report_status_position);
+        } else if (memcmp(report_status_position,compact_position,sizeof(report_status_position))) {
+          int32_t delta[N_AXIS];
+          for (idx=0; idx<N_AXIS; idx++) { delta[idx] = report_status_position[idx]-compact_position[idx]; }
+          printPgmString(PSTR("|D:"));
+          report_util_axis_steps(delta);
+        }
+        memcpy(compact_position,report_status_position,sizeof(report_status_position));
+      } else
+      #endif
+      {
+        // Report machine position
+        if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
+          printPgmString(PSTR("|MPos:"));
+          report_util_position_values(report_status_position,NULL);
+        } else {
+          printPgmString(PSTR("|WPos:"));
+          report_util_position_values(report_status_position,report_status_wco);
+        }
       }
-      if (ctrl_pin_state) {
-        #ifdef ENABLE_SAFETY_DOOR_INPUT_PIN
-          if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_SAFETY_DOOR)) { serial_write('D'); }
+      break;
+
+    case REPORT_STATUS_FIELD_BUFFER:
+      // Returns planner and serial read buffer states.
+      #ifdef REPORT_FIELD_BUFFER_STATE
+        if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_BUFFER_STATE)) {
+          uint8_t plan_available = plan_get_block_buffer_available();
+          uint8_t rx_available = serial_get_rx_buffer_available();
+          #ifdef ENABLE_COMPACT_STATUS_REPORT
+          if (report_status_all || (plan_available != compact_plan_available) || (rx_available != compact_rx_available)) {
+            compact_plan_available = plan_available;
+            compact_rx_available = rx_available;
+          #else
+          {
+          #endif
+            printPgmString(PSTR("|Bf:"));
+            print_uint8_base10(plan_available);
+            serial_write(',');
+            print_uint8_base10(rx_available);
+          }
+        }
+      #endif
+      break;
+
+    case REPORT_STATUS_FIELD_LINE:
+      #ifdef USE_LINE_NUMBERS
+        #ifdef REPORT_FIELD_LINE_NUMBERS
+          // Report current line number
+          {
+            plan_block_t * cur_block = plan_get_current_block();
+            if (cur_block != NULL) {
+              uint32_t ln = cur_block->line_number;
+              #ifdef ENABLE_COMPACT_STATUS_REPORT
+              if ((ln > 0) && (report_status_all || (ln != compact_line_number))) {
+                compact_line_number = ln;
+              #else
+              if (ln > 0) {
+              #endif
+                printPgmString(PSTR("|Ln:"));
+                printInteger(ln);
+              }
+            }
+          }
         #endif
-        if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_RESET)) { serial_write('R'); }
-        if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_FEED_HOLD)) { serial_write('H'); }
-        if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_CYCLE_START)) { serial_write('S'); }
-      }
-    }
-  #endif
+      #endif
+      break;
 
-  #ifdef REPORT_FIELD_WORK_COORD_OFFSET
-    if (sys.report_wco_counter > 0) { sys.report_wco_counter--; }
-    else {
-      if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
-        sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
-      } else { sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT-1); }
-      if (sys.report_ovr_counter == 0) { sys.report_ovr_counter = 1; } // Set override on next report.
-      printPgmString(PSTR("|WCO:"));
-      report_util_axis_values(wco);
-    }
-  #endif
+    case REPORT_STATUS_FIELD_RUN:
+      #ifdef ENABLE_PROGRAM_STORAGE
+        // Report the running program, its current line, and the lines per second executed since the
+        // last report, if timed by the performance counters.
+        if (storage_get_state() == STORAGE_RUNNING) {
+          printPgmString(PSTR("|Run:"));
+          print_uint8_base10(storage_get_program());
+          serial_write(',');
+          print_uint32_base10(storage_get_line_number());
+          #ifdef ENABLE_PERF_COUNTERS
+            serial_write(',');
+            print_uint32_base10(storage_get_line_rate());
+          #endif
+        }
+      #endif
+      break;
 
-  #ifdef REPORT_FIELD_OVERRIDES
-    if (sys.report_ovr_counter > 0) { sys.report_ovr_counter--; }
-    else {
-      if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
-        sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
-      } else { sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT-1); }
-      printPgmString(PSTR("|Ov:"));
-      print_uint8_base10(sys.f_override);
-      serial_write(',');
-      print_uint8_base10(sys.r_override);
-      serial_write(',');
-      print_uint8_base10(sys.spindle_speed_ovr);
-
-      uint8_t sp_state = spindle_get_state();
-      uint8_t cl_state = coolant_get_state();
-      if (sp_state || cl_state) {
-        printPgmString(PSTR("|A:"));
-        if (sp_state) { // != SPINDLE_STATE_DISABLE
-          #ifdef VARIABLE_SPINDLE 
-            #ifdef USE_SPINDLE_DIR_AS_ENABLE_PIN
-              serial_write('S'); // CW
+    case REPORT_STATUS_FIELD_FEED:
+      // Report realtime feed speed
+      #ifdef REPORT_FIELD_CURRENT_FEED_SPEED
+        {
+          float feed_rate = st_get_realtime_rate();
+          #ifdef ENABLE_COMPACT_STATUS_REPORT
+            #ifdef VARIABLE_SPINDLE
+            if (report_status_all || (feed_rate != compact_feed_rate) || (sys.spindle_speed != compact_spindle_speed)) {
+              compact_spindle_speed = sys.spindle_speed;
             #else
-              if (sp_state == SPINDLE_STATE_CW) { serial_write('S'); } // CW
-              else { serial_write('C'); } // CCW
+            if (report_status_all || (feed_rate != compact_feed_rate)) {
             #endif
+              compact_feed_rate = feed_rate;
           #else
-            if (sp_state & SPINDLE_STATE_CW) { serial_write('S'); } // CW
-            else { serial_write('C'); } // CCW
+          {
           #endif
+            #ifdef VARIABLE_SPINDLE
+              printPgmString(PSTR("|FS:"));
+              printFloat_RateValue(feed_rate);
+              serial_write(',');
+              printFloat(sys.spindle_speed,N_DECIMAL_RPMVALUE);
+            #else
+              printPgmString(PSTR("|F:"));
+              printFloat_RateValue(feed_rate);
+            #endif
+          }
         }
-        if (cl_state & COOLANT_STATE_FLOOD) { serial_write('F'); }
-        #ifdef ENABLE_M7
-          if (cl_state & COOLANT_STATE_MIST) { serial_write('M'); }
-        #endif
-      }  
-    }
-  #endif
+      #endif
+      break;
 
-  serial_write('>');
-  report_util_line_feed();
+    case REPORT_STATUS_FIELD_PINS:
+      #ifdef REPORT_FIELD_PIN_STATE
+        {
+          uint8_t lim_pin_state = limits_get_state();
+          uint8_t ctrl_pin_state = system_control_get_state();
+          uint8_t prb_pin_state = probe_get_state();
+          #ifdef ENABLE_COMPACT_STATUS_REPORT
+          // In compact mode, an empty 'Pn:' field is sent when all pins have cleared.
+          uint16_t pin_state = ((uint16_t)lim_pin_state << 8) | (ctrl_pin_state << 1) | (prb_pin_state != 0);
+          if (report_status_compact ? (report_status_all || (pin_state != compact_pin_state)) : pin_state) {
+            compact_pin_state = pin_state;
+          #else
+          if (lim_pin_state | ctrl_pin_state | prb_pin_state) {
+          #endif
+            printPgmString(PSTR("|Pn:"));
+            if (prb_pin_state) { serial_write('P'); }
+            if (lim_pin_state) {
+              #ifdef ENABLE_DUAL_AXIS
+                #if (DUAL_AXIS_SELECT == X_AXIS)
+                  if (bit_istrue(lim_pin_state,(bit(X_AXIS)|bit(N_AXIS)))) { serial_write('X'); }
+                  if (bit_istrue(lim_pin_state,bit(Y_AXIS))) { serial_write('Y'); }
+                #endif
+                #if (DUAL_AXIS_SELECT == Y_AXIS)
+                  if (bit_istrue(lim_pin_state,bit(X_AXIS))) { serial_write('X'); }
+                  if (bit_istrue(lim_pin_state,(bit(Y_AXIS)|bit(N_AXIS)))) { serial_write('Y'); }
+                #endif
+                if (bit_istrue(lim_pin_state,bit(Z_AXIS))) { serial_write('Z'); }
+              #else
+                if (bit_istrue(lim_pin_state,bit(X_AXIS))) { serial_write('X'); }
+                if (bit_istrue(lim_pin_state,bit(Y_AXIS))) { serial_write('Y'); }
+                if (bit_istrue(lim_pin_state,bit(Z_AXIS))) { serial_write('Z'); }
+              #endif
+            }
+            if (ctrl_pin_state) {
+              #ifdef ENABLE_SAFETY_DOOR_INPUT_PIN
+                if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_SAFETY_DOOR)) { serial_write('D'); }
+              #endif
+              if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_RESET)) { serial_write('R'); }
+              if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_FEED_HOLD)) { serial_write('H'); }
+              if (bit_istrue(ctrl_pin_state,CONTROL_PIN_INDEX_CYCLE_START)) { serial_write('S'); }
+            }
+          }
+        }
+      #endif
+      break;
+
+    case REPORT_STATUS_FIELD_WCO:
+      #ifdef REPORT_FIELD_WORK_COORD_OFFSET
+        if (sys.report_wco_counter > 0) { sys.report_wco_counter--; }
+        else {
+          if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
+            sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
+          } else { sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT-1); }
+          if (sys.report_ovr_counter == 0) { sys.report_ovr_counter = 1; } // Set override on next report.
+          printPgmString(PSTR("|WCO:"));
+          report_util_axis_values(report_status_wco);
+        }
+      #endif
+      break;
+
+    case REPORT_STATUS_FIELD_OVERRIDES:
+      #ifdef REPORT_FIELD_OVERRIDES
+        if (sys.report_ovr_counter > 0) { sys.report_ovr_counter--; }
+        else {
+          if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
+            sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
+          } else { sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT-1); }
+          printPgmString(PSTR("|Ov:"));
+          print_uint8_base10(sys.f_override);
+          serial_write(',');
+          print_uint8_base10(sys.r_override);
+          serial_write(',');
+          print_uint8_base10(sys.spindle_speed_ovr);
+
+          uint8_t sp_state = spindle_get_state();
+          uint8_t cl_state = coolant_get_state();
+          if (sp_state || cl_state) {
+            printPgmString(PSTR("|A:"));
+            if (sp_state) { // != SPINDLE_STATE_DISABLE
+              #ifdef VARIABLE_SPINDLE 
+                #ifdef USE_SPINDLE_DIR_AS_ENABLE_PIN
+                  serial_write('S'); // CW
+                #else
+                  if (sp_state == SPINDLE_STATE_CW) { serial_write('S'); } // CW
+                  else { serial_write('C'); } // CCW
+                #endif
+              #else
+                if (sp_state & SPINDLE_STATE_CW) { serial_write('S'); } // CW
+                else { serial_write('C'); } // CCW
+              #endif
+            }
+            if (cl_state & COOLANT_STATE_FLOOD) { serial_write('F'); }
+            #ifdef ENABLE_M7
+              if (cl_state & COOLANT_STATE_MIST) { serial_write('M'); }
+            #endif
+          }  
+        }
+      #endif
+      break;
+
+    default: // REPORT_STATUS_FIELD_END
+      serial_write('>');
+      report_util_line_feed();
+  }
 }
 
 
+ // Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
+ // and the actual location of the CNC machine. Users may change the following function to their
+ // specific needs, but the desired real-time data report must be as short as possible. This is
+ // requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
+ // especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
+void report_realtime_status()
+{
+  #ifdef ENABLE_PERF_COUNTERS
+    uint32_t perf_start = perf_get_ticks();
+  #endif
+  report_realtime_status_finish(); // Complete any chunked status report first.
+  uint8_t field;
+  for (field=0; field<=REPORT_STATUS_FIELD_END; field++) { report_realtime_status_field(field); }
+  #ifdef ENABLE_PERF_COUNTERS
+    perf_record(PERF_TIMER_STATUS_REPORT,perf_start);
+  #endif
+}
+
+
+#ifdef ENABLE_CHUNKED_REPORTS
+  uint8_t report_realtime_status_continue()
+  {
+    #ifdef ENABLE_PERF_COUNTERS
+      uint32_t perf_start = perf_get_ticks();
+      uint8_t field = report_status_field; // Times only the calls that print.
+    #endif
+    uint8_t complete = false;
+    while (serial_get_tx_buffer_available() >= REPORT_STATUS_TX_MIN_FREE) {
+      report_realtime_status_field(report_status_field++);
+      if (report_status_field > REPORT_STATUS_FIELD_END) {
+        report_status_field = 0;
+        complete = true;
+        break;
+      }
+    }
+    #ifdef ENABLE_PERF_COUNTERS
+      if (complete || (report_status_field != field)) { perf_record(PERF_TIMER_STATUS_REPORT,perf_start); }
+    #endif
+    return(complete);
+  }
+
+
+  // Prints the remaining fields of a chunked status report in progress, waiting on the serial TX
+  // buffer if needed. Called before any other report, so that it doesn't land inside the status report.
+  static void report_realtime_status_finish()
+  {
+    while (report_status_field) {
+      report_realtime_status_field(report_status_field++);
+      if (report_status_field > REPORT_STATUS_FIELD_END) { report_status_field = 0; }
+    }
+  }
+#endif
+
+
 #ifdef DEBUG
   void report_realtime_debug()
   {
@@ -39,6 +39,8 @@
 #define STATUS_TRAVEL_EXCEEDED 15
 #define STATUS_INVALID_JOG_COMMAND 16
 #define STATUS_SETTING_DISABLED_LASER 17
+#define STATUS_STORAGE_FAILED 18
+#define STATUS_STORAGE_BUSY 19
 
 #define STATUS_GCODE_UNSUPPORTED_COMMAND 20
 #define STATUS_GCODE_MODAL_GROUP_VIOLATION 21
@@ -59,6 +61,10 @@
 #define STATUS_GCODE_UNUSED_WORDS 36
 #define STATUS_GCODE_G43_DYNAMIC_AXIS_ERROR 37
 #define STATUS_GCODE_MAX_VALUE_EXCEEDED 38
+#define STATUS_GCODE_UNDEFINED_SUBPROGRAM 39
+#define STATUS_GCODE_SUBPROGRAM_STORE_FULL 40
+#define STATUS_GCODE_SUBPROGRAM_NESTING 41
+#define STATUS_GCODE_SPLINE_PLANE 42
 
 // Define Grbl alarm codes. Valid values (1-255). 0 is reserved.
 #define ALARM_HARD_LIMIT_ERROR      EXEC_ALARM_HARD_LIMIT
@@ -108,9 +114,28 @@ void report_echo_line_received(char *line);
 // Prints realtime status report
 void report_realtime_status();
 
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  // Set by the auto report timer, when a periodic status report is due.
+  extern volatile uint8_t report_auto_pending;
+
+  // Initializes or restarts the auto status report timer at the '$33' interval.
+  void report_auto_init();
+
+  // Prints a periodic status report, if any reported state has changed when configured to.
+  void report_auto_status();
+#endif
+
 // Prints recorded probe position
 void report_probe_parameters();
 
+#ifdef ENABLE_PROGRAM_STORAGE
+  // Prints the number and size of a stored program.
+  void report_storage_program(uint8_t program, uint32_t size);
+
+  // Prints the line a stored program ended on, with the status of that line.
+  void report_storage_run_end(uint8_t program, uint32_t line_number, uint8_t status_code);
+#endif
+
 // Prints Grbl NGC parameters (coordinate offsets, probe)
 void report_ngc_parameters();
 
@@ -124,6 +149,57 @@ void report_execute_startup_message(char *line, uint8_t status_code);
 // Prints build info and user info
 void report_build_info(char *line);
 
+#ifdef ENABLE_PERF_COUNTERS
+  // Prints performance timers and event counters
+  void report_perf_counters();
+#endif
+
+#ifdef ENABLE_CHECK_MODE_ESTIMATE
+  #define N_DECIMAL_ESTIMATE 3 // Estimated time decimal places (seconds)
+
+  // Prints the check mode estimated execution time of a program.
+  void report_estimate_total(float seconds);
+
+  // Prints the check mode estimated motion time of a line.
+  void report_estimate_line(int32_t line_number, float seconds);
+#endif
+
+#ifdef ENABLE_MOTION_TRACE
+  // Prints the executed-motion trace records
+  void report_motion_trace();
+#endif
+
+#ifdef ENABLE_CHUNKED_REPORTS
+  #ifndef REPORT_CHUNK_TX_MIN_FREE
+    #define REPORT_CHUNK_TX_MIN_FREE 40
+  #endif
+  #ifndef REPORT_STATUS_TX_MIN_FREE
+    #define REPORT_STATUS_TX_MIN_FREE 48
+  #endif
+
+  // Define chunked report types.
+  #define REPORT_CHUNK_NONE 0
+  #define REPORT_CHUNK_SETTINGS 1 // '$$'
+  #define REPORT_CHUNK_NGC_PARAMETERS 2 // '$#'
+  #define REPORT_CHUNK_BUILD_INFO 3 // '$I'. Prints the given build info line.
+  #define REPORT_CHUNK_PERF_COUNTERS 4 // '$P'
+  #define REPORT_CHUNK_MOTION_TRACE 5 // '$T'
+
+  // Starts a chunked report, printed by the main loop as serial TX buffer space allows. The status
+  // message of the requesting command is held until the report is complete.
+  void report_chunked_start(uint8_t type, char *line);
+
+  // Prints the next lines of the active chunked report. Returns true while a report is active.
+  uint8_t report_chunked_continue();
+
+  // Abandons any active chunked report. Called by the system abort/initialization routine.
+  void report_chunked_reset();
+
+  // Prints the next fields of a status report, starting a new report if none is in progress, while
+  // the serial TX buffer has room for a field. Returns true when the report is complete.
+  uint8_t report_realtime_status_continue();
+#endif
+
 #ifdef DEBUG
   void report_realtime_debug();
 #endif
@@ -52,6 +52,13 @@ uint8_t serial_get_rx_buffer_count()
 }
 
 
+// Returns the number of bytes available in the TX serial buffer.
+uint8_t serial_get_tx_buffer_available()
+{
+  return(TX_BUFFER_SIZE - serial_get_tx_buffer_count());
+}
+
+
 // Returns the number of bytes used in the TX serial buffer.
 // NOTE: Not used except for debugging and ensuring no TX bottlenecks.
 uint8_t serial_get_tx_buffer_count()
@@ -193,6 +200,9 @@ ISR(SERIAL_RX)
           serial_rx_buffer[serial_rx_buffer_head] = data;
           serial_rx_buffer_head = next_head;
         }
+        #ifdef ENABLE_PERF_COUNTERS
+          else { perf_count_event(PERF_EVENT_RX_OVERFLOW); }
+        #endif
       }
   }
 }
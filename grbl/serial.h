@@ -55,6 +55,9 @@ uint8_t serial_get_rx_buffer_available();
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h.
 uint8_t serial_get_rx_buffer_count();
 
+// Returns the number of bytes available in the TX serial buffer.
+uint8_t serial_get_tx_buffer_available();
+
 // Returns the number of bytes used in the TX serial buffer.
 // NOTE: Not used except for debugging and ensuring no TX bottlenecks.
 uint8_t serial_get_tx_buffer_count();
@@ -38,6 +38,9 @@ const __flash settings_t defaults = {\
     .homing_seek_rate = DEFAULT_HOMING_SEEK_RATE,
     .homing_debounce_delay = DEFAULT_HOMING_DEBOUNCE_DELAY,
     .homing_pulloff = DEFAULT_HOMING_PULLOFF,
+    #ifdef ENABLE_AUTO_STATUS_REPORT
+      .status_report_interval = DEFAULT_STATUS_REPORT_INTERVAL,
+    #endif
     .flags = (DEFAULT_REPORT_INCHES << BIT_REPORT_INCHES) | \
              (DEFAULT_LASER_MODE << BIT_LASER_MODE) | \
              (DEFAULT_INVERT_ST_ENABLE << BIT_INVERT_ST_ENABLE) | \
@@ -129,6 +132,13 @@ void settings_restore(uint8_t restore_flag) {
     eeprom_put_char(EEPROM_ADDR_BUILD_INFO , 0);
     eeprom_put_char(EEPROM_ADDR_BUILD_INFO+1 , 0); // Checksum
   }
+
+  #ifdef ENABLE_SUBPROGRAMS
+    if (restore_flag & SETTINGS_RESTORE_SUBPROGRAMS) {
+      eeprom_put_char(EEPROM_ADDR_SUBPROGRAM, 0xff); // Erased subprogram number marks an empty store.
+      eeprom_put_char(EEPROM_ADDR_SUBPROGRAM+1, 0xff);
+    }
+  #endif
 }
 
 
@@ -253,7 +263,12 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
         else { settings.flags &= ~BITFLAG_INVERT_PROBE_PIN; }
         probe_configure_invert_mask(false);
         break;
-      case 10: settings.status_report_mask = int_value; break;
+      case 10:
+        settings.status_report_mask = int_value;
+        #ifdef ENABLE_COMPACT_STATUS_REPORT
+          sys.report_wco_counter = 0; // Send a full report next. Resynchronizes compact reports.
+        #endif
+        break;
       case 11: settings.junction_deviation = value; break;
       case 12: settings.arc_tolerance = value; break;
       case 13:
@@ -294,6 +309,13 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
           return(STATUS_SETTING_DISABLED_LASER);
         #endif
         break;
+      #ifdef ENABLE_AUTO_STATUS_REPORT
+        case 33:
+          if (value > 0.0) { value = min(max(value,AUTO_STATUS_REPORT_MIN_INTERVAL),0xffff); }
+          settings.status_report_interval = value;
+          report_auto_init(); // Restart report timer at new interval.
+          break;
+      #endif
       default:
         return(STATUS_INVALID_STATEMENT);
     }
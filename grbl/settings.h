@@ -27,7 +27,12 @@
 
 // Version of the EEPROM data. Will be used to migrate existing data from older versions of Grbl
 // when firmware is upgraded. Always stored in byte 0 of eeprom
-#define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+// NOTE: ENABLE_AUTO_STATUS_REPORT adds the $33 interval to settings_t, which changes its layout.
+#ifdef ENABLE_AUTO_STATUS_REPORT
+  #define SETTINGS_VERSION 11  // NOTE: Check settings_reset() when moving to next version.
+#else
+  #define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+#endif
 
 // Define bit flag masks for the boolean settings in settings.flag.
 #define BIT_REPORT_INCHES      0
@@ -51,12 +56,15 @@
 // Define status reporting boolean enable bit flags in settings.status_report_mask
 #define BITFLAG_RT_STATUS_POSITION_TYPE     bit(0)
 #define BITFLAG_RT_STATUS_BUFFER_STATE      bit(1)
+#define BITFLAG_RT_STATUS_AUTO_ON_CHANGE    bit(2)
+#define BITFLAG_RT_STATUS_COMPACT           bit(3)
 
 // Define settings restore bitflags.
 #define SETTINGS_RESTORE_DEFAULTS bit(0)
 #define SETTINGS_RESTORE_PARAMETERS bit(1)
 #define SETTINGS_RESTORE_STARTUP_LINES bit(2)
 #define SETTINGS_RESTORE_BUILD_INFO bit(3)
+#define SETTINGS_RESTORE_SUBPROGRAMS bit(4)
 #ifndef SETTINGS_RESTORE_ALL
   #define SETTINGS_RESTORE_ALL 0xFF // All bitflags
 #endif
@@ -64,8 +72,9 @@
 // Define EEPROM memory address location values for Grbl settings and parameters
 // NOTE: The Atmega328p has 1KB EEPROM. The upper half is reserved for parameters and
 // the startup script. The lower half contains the global settings and space for future
-// developments.
+// developments, which is shared with the optional subprogram store.
 #define EEPROM_ADDR_GLOBAL         1U
+#define EEPROM_ADDR_SUBPROGRAM     192U
 #define EEPROM_ADDR_PARAMETERS     512U
 #define EEPROM_ADDR_STARTUP_BLOCK  768U
 #define EEPROM_ADDR_BUILD_INFO     942U
@@ -110,6 +119,10 @@ typedef struct {
   float homing_seek_rate;
   uint16_t homing_debounce_delay;
   float homing_pulloff;
+
+  #ifdef ENABLE_AUTO_STATUS_REPORT
+    uint16_t status_report_interval; // Auto status report interval in milliseconds. Zero disables.
+  #endif
 } settings_t;
 extern settings_t settings;
 
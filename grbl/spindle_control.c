@@ -26,6 +26,21 @@
   static float pwm_gradient; // Precalulated value to speed up rpm to PWM conversions.
 #endif
 
+#ifdef ENABLE_SPINDLE_PWM_DITHERING
+  // PWM dithering state. The overflow interrupt outputs the base PWM register value, plus one
+  // whenever the fractional accumulator rolls over.
+  static volatile uint8_t pwm_dither_base;
+  static volatile uint8_t pwm_dither_frac;
+  static uint16_t pwm_dither_accum;
+#endif
+
+#ifdef ENABLE_SPINDLE_PWM_TABLE
+  // Nonlinear spindle PWM lookup table, evenly spaced in RPM. Generated by 'fit_nonlinear_spindle.py'.
+  static const uint8_t spindle_pwm_table[N_PWM_TABLE] PROGMEM = SPINDLE_PWM_TABLE;
+  // Converts RPM to a table position in 8.8 fixed-point. Upper byte is the index and lower the fraction.
+  #define RPM_TABLE_SCALE (((N_PWM_TABLE-1)*256.0)/(RPM_TABLE_MAX-RPM_TABLE_MIN))
+#endif
+
 
 void spindle_init()
 {
@@ -42,13 +57,17 @@ void spindle_init()
         SPINDLE_DIRECTION_DDR |= (1<<SPINDLE_DIRECTION_BIT); // Configure as output pin.
       #endif
     #endif
-    pwm_gradient = SPINDLE_PWM_RANGE/(settings.rpm_max-settings.rpm_min);
+    pwm_gradient = (SPINDLE_PWM_SCALE*SPINDLE_PWM_RANGE)/(settings.rpm_max-settings.rpm_min);
   #else
     SPINDLE_ENABLE_DDR |= (1<<SPINDLE_ENABLE_BIT); // Configure as output pin.
     #ifndef ENABLE_DUAL_AXIS
       SPINDLE_DIRECTION_DDR |= (1<<SPINDLE_DIRECTION_BIT); // Configure as output pin.
     #endif
   #endif
+  #ifdef USE_SPINDLE_AT_SPEED_INPUT_PIN
+    SPINDLE_AT_SPEED_DDR &= ~(1<<SPINDLE_AT_SPEED_BIT); // Configure as input pin
+    SPINDLE_AT_SPEED_PORT |= (1<<SPINDLE_AT_SPEED_BIT); // Enable internal pull-up resistor. Normal high operation.
+  #endif
 
   spindle_stop();
 }
@@ -99,6 +118,9 @@ void spindle_stop()
 {
   #ifdef VARIABLE_SPINDLE
     SPINDLE_TCCRA_REGISTER &= ~(1<<SPINDLE_COMB_BIT); // Disable PWM. Output voltage is zero.
+    #ifdef ENABLE_SPINDLE_PWM_DITHERING
+      SPINDLE_TIMSK_REGISTER &= ~(1<<SPINDLE_TOIE_BIT); // Disable PWM dithering interrupt.
+    #endif
     #ifdef USE_SPINDLE_DIR_AS_ENABLE_PIN
       #ifdef INVERT_SPINDLE_ENABLE_PIN
         SPINDLE_ENABLE_PORT |= (1<<SPINDLE_ENABLE_BIT);  // Set pin to high
@@ -119,9 +141,18 @@ void spindle_stop()
 #ifdef VARIABLE_SPINDLE
   // Sets spindle speed PWM output and enable pin, if configured. Called by spindle_set_state()
   // and stepper ISR. Keep routine small and efficient.
-  void spindle_set_speed(uint8_t pwm_value)
+  void spindle_set_speed(spindle_pwm_t pwm_value)
   {
-    SPINDLE_OCR_REGISTER = pwm_value; // Set PWM output level.
+    #ifdef ENABLE_SPINDLE_PWM_DITHERING
+      // Split into PWM register value and fraction. Only dither when there is a fractional part.
+      pwm_dither_base = (pwm_value >> SPINDLE_PWM_FRAC_BITS);
+      pwm_dither_frac = (pwm_value & (SPINDLE_PWM_SCALE-1));
+      SPINDLE_OCR_REGISTER = pwm_dither_base; // Set PWM output level.
+      if (pwm_dither_frac) { SPINDLE_TIMSK_REGISTER |= (1<<SPINDLE_TOIE_BIT); }
+      else { SPINDLE_TIMSK_REGISTER &= ~(1<<SPINDLE_TOIE_BIT); }
+    #else
+      SPINDLE_OCR_REGISTER = pwm_value; // Set PWM output level.
+    #endif
     #ifdef SPINDLE_ENABLE_OFF_WITH_ZERO_SPEED
       if (pwm_value == SPINDLE_PWM_OFF_VALUE) {
         spindle_stop();
@@ -143,74 +174,125 @@ void spindle_stop()
   }
 
 
+  #ifdef ENABLE_SPINDLE_PWM_DITHERING
+    // Spindle PWM dithering interrupt. Fires at the start of each PWM period, only when the output
+    // has a fractional part, and loads the compare value for the next period. Over 2^SPINDLE_PWM_FRAC_BITS
+    // periods, the register is incremented by one in proportion to the fractional value.
+    // NOTE: The fast PWM compare register is double-buffered and updated at the bottom of the timer.
+    // Values above the 8-bit maximum can't occur, since the maximum PWM value has no fractional part.
+    ISR(SPINDLE_TIMER_OVF_vect)
+    {
+      pwm_dither_accum += pwm_dither_frac;
+      if (pwm_dither_accum & SPINDLE_PWM_SCALE) {
+        pwm_dither_accum -= SPINDLE_PWM_SCALE;
+        SPINDLE_OCR_REGISTER = pwm_dither_base+1;
+      } else {
+        SPINDLE_OCR_REGISTER = pwm_dither_base;
+      }
+    }
+  #endif
+
+
   #ifdef ENABLE_PIECEWISE_LINEAR_SPINDLE
   
     // Called by spindle_set_state() and step segment generator. Keep routine small and efficient.
-    uint8_t spindle_compute_pwm_value(float rpm) // 328p PWM register is 8-bit.
+    spindle_pwm_t spindle_compute_pwm_value(float rpm) // 328p PWM register is 8-bit.
     {
-      uint8_t pwm_value;
+      spindle_pwm_t pwm_value;
       rpm *= (0.010*sys.spindle_speed_ovr); // Scale by spindle speed override value.
       // Calculate PWM register value based on rpm max/min settings and programmed rpm.
       if ((settings.rpm_min >= settings.rpm_max) || (rpm >= RPM_MAX)) {
         rpm = RPM_MAX;
-        pwm_value = SPINDLE_PWM_MAX_VALUE;
+        pwm_value = SPINDLE_PWM_SCALE*SPINDLE_PWM_MAX_VALUE;
       } else if (rpm <= RPM_MIN) {
         if (rpm == 0.0) { // S0 disables spindle
           pwm_value = SPINDLE_PWM_OFF_VALUE;
         } else {
           rpm = RPM_MIN;
-          pwm_value = SPINDLE_PWM_MIN_VALUE;
+          pwm_value = SPINDLE_PWM_SCALE*SPINDLE_PWM_MIN_VALUE;
         }
       } else {
         // Compute intermediate PWM value with linear spindle speed model via piecewise linear fit model.
         #if (N_PIECES > 3)
           if (rpm > RPM_POINT34) {
-            pwm_value = floor(RPM_LINE_A4*rpm - RPM_LINE_B4);
+            pwm_value = floor((SPINDLE_PWM_SCALE*RPM_LINE_A4)*rpm - (SPINDLE_PWM_SCALE*RPM_LINE_B4));
           } else 
         #endif
         #if (N_PIECES > 2)
           if (rpm > RPM_POINT23) {
-            pwm_value = floor(RPM_LINE_A3*rpm - RPM_LINE_B3);
+            pwm_value = floor((SPINDLE_PWM_SCALE*RPM_LINE_A3)*rpm - (SPINDLE_PWM_SCALE*RPM_LINE_B3));
           } else 
         #endif
         #if (N_PIECES > 1)
           if (rpm > RPM_POINT12) {
-            pwm_value = floor(RPM_LINE_A2*rpm - RPM_LINE_B2);
+            pwm_value = floor((SPINDLE_PWM_SCALE*RPM_LINE_A2)*rpm - (SPINDLE_PWM_SCALE*RPM_LINE_B2));
           } else 
         #endif
         {
-          pwm_value = floor(RPM_LINE_A1*rpm - RPM_LINE_B1);
+          pwm_value = floor((SPINDLE_PWM_SCALE*RPM_LINE_A1)*rpm - (SPINDLE_PWM_SCALE*RPM_LINE_B1));
         }
       }
       sys.spindle_speed = rpm;
       return(pwm_value);
     }
     
+  #elif defined(ENABLE_SPINDLE_PWM_TABLE)
+
+    // Called by spindle_set_state() and step segment generator. Keep routine small and efficient.
+    spindle_pwm_t spindle_compute_pwm_value(float rpm) // 328p PWM register is 8-bit.
+    {
+      spindle_pwm_t pwm_value;
+      rpm *= (0.010*sys.spindle_speed_ovr); // Scale by spindle speed override value.
+      // Calculate PWM register value based on rpm max/min settings and programmed rpm.
+      // Outside the table rpm range, limit the output to the first and last table values.
+      if ((settings.rpm_min >= settings.rpm_max) || (rpm >= RPM_TABLE_MAX)) {
+        rpm = RPM_TABLE_MAX;
+        pwm_value = SPINDLE_PWM_SCALE*pgm_read_byte_near(&spindle_pwm_table[N_PWM_TABLE-1]);
+      } else if (rpm <= RPM_TABLE_MIN) {
+        if (rpm == 0.0) { // S0 disables spindle
+          pwm_value = SPINDLE_PWM_OFF_VALUE;
+        } else {
+          rpm = RPM_TABLE_MIN;
+          pwm_value = SPINDLE_PWM_SCALE*pgm_read_byte_near(&spindle_pwm_table[0]);
+        }
+      } else {
+        // Compute intermediate PWM value by linear interpolation of the lookup table entries
+        // bracketing the programmed rpm. Only the table position requires a float computation.
+        uint16_t position = (rpm-RPM_TABLE_MIN)*RPM_TABLE_SCALE;
+        uint8_t idx = (position >> 8);
+        uint8_t pwm_lo = pgm_read_byte_near(&spindle_pwm_table[idx]);
+        uint8_t pwm_hi = pgm_read_byte_near(&spindle_pwm_table[idx+1]);
+        pwm_value = SPINDLE_PWM_SCALE*pwm_lo + (((uint16_t)(pwm_hi-pwm_lo)*(position & 0xff)) >> (8-SPINDLE_PWM_FRAC_BITS));
+      }
+      sys.spindle_speed = rpm;
+      return(pwm_value);
+    }
+
   #else 
   
     // Called by spindle_set_state() and step segment generator. Keep routine small and efficient.
-    uint8_t spindle_compute_pwm_value(float rpm) // 328p PWM register is 8-bit.
+    spindle_pwm_t spindle_compute_pwm_value(float rpm) // 328p PWM register is 8-bit.
     {
-      uint8_t pwm_value;
+      spindle_pwm_t pwm_value;
       rpm *= (0.010*sys.spindle_speed_ovr); // Scale by spindle speed override value.
       // Calculate PWM register value based on rpm max/min settings and programmed rpm.
       if ((settings.rpm_min >= settings.rpm_max) || (rpm >= settings.rpm_max)) {
         // No PWM range possible. Set simple on/off spindle control pin state.
         sys.spindle_speed = settings.rpm_max;
-        pwm_value = SPINDLE_PWM_MAX_VALUE;
+        pwm_value = SPINDLE_PWM_SCALE*SPINDLE_PWM_MAX_VALUE;
       } else if (rpm <= settings.rpm_min) {
         if (rpm == 0.0) { // S0 disables spindle
           sys.spindle_speed = 0.0;
           pwm_value = SPINDLE_PWM_OFF_VALUE;
         } else { // Set minimum PWM output
           sys.spindle_speed = settings.rpm_min;
-          pwm_value = SPINDLE_PWM_MIN_VALUE;
+          pwm_value = SPINDLE_PWM_SCALE*SPINDLE_PWM_MIN_VALUE;
         }
       } else { 
         // Compute intermediate PWM value with linear spindle speed model.
         // NOTE: A nonlinear model could be installed here, if required, but keep it VERY light-weight.
         sys.spindle_speed = rpm;
-        pwm_value = floor((rpm-settings.rpm_min)*pwm_gradient) + SPINDLE_PWM_MIN_VALUE;
+        pwm_value = floor((rpm-settings.rpm_min)*pwm_gradient) + SPINDLE_PWM_SCALE*SPINDLE_PWM_MIN_VALUE;
       }
       return(pwm_value);
     }
@@ -271,20 +353,106 @@ void spindle_stop()
 }
 
 
+#ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+  #ifdef USE_SPINDLE_AT_SPEED_INPUT_PIN
+    // Returns true, if the spindle drive at-speed output is active.
+    static uint8_t spindle_is_at_speed()
+    {
+      #ifdef INVERT_SPINDLE_AT_SPEED_PIN
+        return(bit_istrue(SPINDLE_AT_SPEED_PIN,(1<<SPINDLE_AT_SPEED_BIT)));
+      #else
+        return(bit_isfalse(SPINDLE_AT_SPEED_PIN,(1<<SPINDLE_AT_SPEED_BIT)));
+      #endif
+    }
+  #endif
+
+
+  // Blocks after a spindle start, reversal, or speed change until the spindle reaches its new speed.
+  // Either delays by the modelled ramp time or polls the at-speed input, which alarms on a timeout.
+  // Returns immediately, if the spindle has stopped or is unchanged, or in laser mode.
+  // NOTE: Non-blocking in the same manner as delay_sec(). Exits on an abort or reopened safety door.
+  #ifdef VARIABLE_SPINDLE
+    void spindle_wait_at_speed(uint8_t prior_state, float prior_rpm, uint8_t mode)
+  #else
+    void _spindle_wait_at_speed(uint8_t prior_state, uint8_t mode)
+  #endif
+  {
+    if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) { return; }
+    uint8_t state = spindle_get_state();
+    if (state == SPINDLE_STATE_DISABLE) { return; }
+    #ifdef VARIABLE_SPINDLE
+      // Compute the change in spindle speed. A reversal must decelerate through zero first.
+      float rpm_change = sys.spindle_speed;
+      if (state == prior_state) { rpm_change = fabs(rpm_change-prior_rpm); }
+      else if (prior_state != SPINDLE_STATE_DISABLE) { rpm_change += prior_rpm; }
+      if (rpm_change == 0.0) { return; }
+    #else
+      if (state == prior_state) { return; }
+    #endif
+
+    #ifdef USE_SPINDLE_AT_SPEED_INPUT_PIN
+      // Poll after each dwell time step, which also allows the drive time to clear its output.
+      uint16_t i = ceil(1000/DWELL_TIME_STEP*SPINDLE_AT_SPEED_TIMEOUT);
+      while (i-- > 0) {
+        if (sys.abort) { return; }
+        if (mode == DELAY_MODE_DWELL) {
+          protocol_execute_realtime();
+        } else { // DELAY_MODE_SYS_SUSPEND
+          // Execute rt_system() only to avoid nesting suspend loops.
+          protocol_exec_rt_system();
+          if (sys.suspend & SUSPEND_RESTART_RETRACT) { return; } // Bail, if safety door reopens.
+        }
+        _delay_ms(DWELL_TIME_STEP); // Delay DWELL_TIME_STEP increment
+        if (spindle_is_at_speed()) { return; }
+      }
+      // Spindle failed to reach speed. Halt and alarm. Don't resume cutting with a stalled spindle.
+      system_set_exec_alarm(EXEC_ALARM_SPINDLE_AT_SPEED);
+      mc_reset();
+      protocol_exec_rt_system();
+    #else
+      delay_sec(rpm_change*(1.0/SPINDLE_RAMP_RATE), mode);
+    #endif
+  }
+#endif
+
+
 // G-code parser entry-point for setting spindle state. Forces a planner buffer sync and bails 
 // if an abort or check-mode is active.
 #ifdef VARIABLE_SPINDLE
   void spindle_sync(uint8_t state, float rpm)
   {
-    if (sys.state == STATE_CHECK_MODE) { return; }
+    if (sys.state == STATE_CHECK_MODE) {
+      #ifdef ENABLE_CHECK_MODE_ESTIMATE
+        protocol_buffer_synchronize(); // Estimate the motion stop of the buffer sync.
+      #endif
+      return;
+    }
     protocol_buffer_synchronize(); // Empty planner buffer to ensure spindle is set when programmed.
-    spindle_set_state(state,rpm);
+    #ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+      uint8_t prior_state = spindle_get_state();
+      float prior_rpm = sys.spindle_speed;
+      spindle_set_state(state,rpm);
+      spindle_wait_at_speed(prior_state, prior_rpm, DELAY_MODE_DWELL);
+    #else
+      spindle_set_state(state,rpm);
+    #endif
   }
 #else
   void _spindle_sync(uint8_t state)
   {
-    if (sys.state == STATE_CHECK_MODE) { return; }
+    if (sys.state == STATE_CHECK_MODE) {
+      #ifdef ENABLE_CHECK_MODE_ESTIMATE
+        protocol_buffer_synchronize(); // Estimate the motion stop of the buffer sync.
+      #endif
+      return;
+    }
     protocol_buffer_synchronize(); // Empty planner buffer to ensure spindle is set when programmed.
-    _spindle_set_state(state);
+    #ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+      uint8_t prior_state = spindle_get_state();
+      _spindle_set_state(state);
+      _spindle_wait_at_speed(prior_state, DELAY_MODE_DWELL);
+    #else
+      _spindle_set_state(state);
+    #endif
   }
 #endif
@@ -29,6 +29,28 @@
 #define SPINDLE_STATE_CW       bit(0)
 #define SPINDLE_STATE_CCW      bit(1)
 
+// Spindle PWM output value type. With PWM dithering, values carry SPINDLE_PWM_FRAC_BITS of
+// fractional resolution below the 8-bit PWM register value.
+#ifdef ENABLE_SPINDLE_PWM_DITHERING
+  #define SPINDLE_PWM_FRAC_BITS SPINDLE_PWM_DITHER_BITS
+  typedef uint16_t spindle_pwm_t;
+#else
+  #define SPINDLE_PWM_FRAC_BITS 0
+  typedef uint8_t spindle_pwm_t;
+#endif
+#define SPINDLE_PWM_SCALE (1<<SPINDLE_PWM_FRAC_BITS)
+
+// Spindle timer clock select bits and prescaler. The timer also ticks the auto status reports and
+// performance counters, which run it in normal mode at 1/64, if not used by the spindle PWM.
+#ifdef VARIABLE_SPINDLE
+  #define SPINDLE_TIMER_CS (SPINDLE_TCCRB_INIT_MASK & 0x07) // Set by spindle_init().
+#else
+  #define SPINDLE_TIMER_CS (1<<CS22) // 1/64 prescaler.
+#endif
+#define SPINDLE_TIMER_PRESCALER ( (SPINDLE_TIMER_CS == 1) ? 1 : (SPINDLE_TIMER_CS == 2) ? 8 : \
+  (SPINDLE_TIMER_CS == 3) ? 32 : (SPINDLE_TIMER_CS == 4) ? 64 : (SPINDLE_TIMER_CS == 5) ? 128 : \
+  (SPINDLE_TIMER_CS == 6) ? 256 : 1024 )
+
 
 // Initializes spindle pins and hardware PWM, if enabled.
 void spindle_init();
@@ -48,11 +70,11 @@ uint8_t spindle_get_state();
   void spindle_set_state(uint8_t state, float rpm); 
   
   // Sets spindle PWM quickly for stepper ISR. Also called by spindle_set_state().
-  // NOTE: 328p PWM register is 8-bit.
-  void spindle_set_speed(uint8_t pwm_value);
+  // NOTE: 328p PWM register is 8-bit. Any fractional bits are output by PWM dithering.
+  void spindle_set_speed(spindle_pwm_t pwm_value);
   
   // Computes 328p-specific PWM register value for the given RPM for quick updating.
-  uint8_t spindle_compute_pwm_value(float rpm);
+  spindle_pwm_t spindle_compute_pwm_value(float rpm);
   
 #else
   
@@ -69,5 +91,16 @@ uint8_t spindle_get_state();
 // Stop and start spindle routines. Called by all spindle routines and stepper ISR.
 void spindle_stop();
 
+#ifdef ENABLE_SPINDLE_AT_SPEED_WAIT
+  // Blocks after a spindle state change from the prior state and rpm until the spindle is at speed.
+  // Uses the given delay mode, as with delay_sec().
+  #ifdef VARIABLE_SPINDLE
+    void spindle_wait_at_speed(uint8_t prior_state, float prior_rpm, uint8_t mode);
+  #else
+    #define spindle_wait_at_speed(prior_state, prior_rpm, mode) _spindle_wait_at_speed(prior_state, mode)
+    void _spindle_wait_at_speed(uint8_t prior_state, uint8_t mode);
+  #endif
+#endif
+
 
 #endif
@@ -73,6 +73,12 @@ typedef struct {
   #ifdef VARIABLE_SPINDLE
     uint8_t is_pwm_rate_adjusted; // Tracks motions that require constant laser power/rate
   #endif
+  #ifdef ENABLE_LASER_RASTER
+    uint32_t raster_count; // Raster pixels traced as a Bresenham axis. Zero if not a scanline.
+  #endif
+  #if (defined(ENABLE_MOTION_TRACE) || defined(ENABLE_CHECK_MODE_ESTIMATE)) && defined(USE_LINE_NUMBERS)
+    int32_t line_number; // Planner block line number for the motion trace and estimator.
+  #endif
 } st_block_t;
 static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE-1];
 
@@ -90,11 +96,31 @@ typedef struct {
     uint8_t prescaler;      // Without AMASS, a prescaler is required to adjust for slow timing.
   #endif
   #ifdef VARIABLE_SPINDLE
-    uint8_t spindle_pwm;
+    spindle_pwm_t spindle_pwm;
   #endif
 } segment_t;
 static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 
+#ifdef ENABLE_MOTION_TRACE
+  // Executed-motion trace ring buffer. The stepper ISR records every completed segment, overwriting
+  // the oldest records. Not cleared by a reset, so that it is kept for post-mortem analysis.
+  static st_trace_t st_trace_buffer[MOTION_TRACE_SIZE];
+  static uint8_t st_trace_head;  // Index of the next record to write
+  static uint8_t st_trace_count; // Number of valid records
+#endif
+
+#ifdef ENABLE_CHECK_MODE_ESTIMATE
+  // Virtual clock of the check mode estimator. Kept as whole seconds and the remaining CPU cycles,
+  // so that long programs don't lose the time of short segments to float round-off.
+  static uint32_t st_estimate_seconds;
+  static uint32_t st_estimate_cycles;
+  #ifdef USE_LINE_NUMBERS
+    static uint8_t st_estimate_line_active; // Flags a line with estimated motion not yet reported.
+    static int32_t st_estimate_line_number; // Line number of the motion being estimated.
+    static float st_estimate_line_start;    // Virtual clock time when the motion of the line began.
+  #endif
+#endif
+
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
 typedef struct {
   // Used by the bresenham line algorithm
@@ -116,6 +142,22 @@ typedef struct {
   #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
     uint32_t steps[N_AXIS];
   #endif
+  #ifdef VARIABLE_SPINDLE
+    spindle_pwm_t spindle_pwm; // Segment spindle PWM output, before any raster pixel scaling.
+  #endif
+  #ifdef ENABLE_LASER_PWM_INTERPOLATION
+    uint16_t pwm_counter;     // Bresenham counter for ramping the laser PWM across a segment.
+    spindle_pwm_t pwm_delta;  // Bresenham numerator. Segment PWM change modulo its step events.
+    spindle_pwm_t pwm_step;   // Whole PWM counts ramped per step event. Zero unless a steep ramp.
+    int8_t pwm_increment;     // Direction of the PWM ramp. (+1 or -1)
+  #endif
+  #ifdef ENABLE_LASER_RASTER
+    uint32_t counter_raster;  // Bresenham counter for raster pixel boundaries
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      uint32_t steps_raster;
+    #endif
+    uint8_t raster_pixel;     // Power of the raster pixel being traced
+  #endif
 
   uint16_t step_count;       // Steps remaining in line segment motion
   uint8_t exec_block_index; // Tracks the current st_block index. Change indicates new block.
@@ -174,11 +216,21 @@ typedef struct {
 
   #ifdef VARIABLE_SPINDLE
     float inv_rate;    // Used by PWM laser mode to speed up segment calculations.
-    uint8_t current_spindle_pwm; 
+    spindle_pwm_t current_spindle_pwm; 
   #endif
 } st_prep_t;
 static st_prep_t prep;
 
+#ifdef ENABLE_LASER_RASTER
+  // Scales the segment laser PWM by the 8-bit raster pixel power. A full power pixel (255) returns
+  // the segment PWM unaltered, while a zero power pixel turns the laser off.
+  #ifdef ENABLE_SPINDLE_PWM_DITHERING
+    #define RASTER_PIXEL_PWM(pixel,pwm) ((((uint32_t)((pixel)+((pixel)>>7)))*(pwm)) >> 8)
+  #else
+    #define RASTER_PIXEL_PWM(pixel,pwm) ((((uint16_t)(pixel))*((pwm)+1)) >> 8)
+  #endif
+#endif
+
 
 /*    BLOCK VELOCITY PROFILE DEFINITION
           __________________________
@@ -371,6 +423,11 @@ ISR(TIMER1_COMPA_vect)
 
         // Initialize Bresenham line and distance counters
         st.counter_x = st.counter_y = st.counter_z = (st.exec_block->step_event_count >> 1);
+        #ifdef ENABLE_LASER_RASTER
+          // Preload the raster counter, so the first pixel is loaded with the first step event.
+          st.counter_raster = st.exec_block->step_event_count;
+          st.raster_pixel = 0;
+        #endif
       }
       st.dir_outbits = st.exec_block->direction_bits ^ dir_port_invert_mask;
       #ifdef ENABLE_DUAL_AXIS
@@ -382,19 +439,64 @@ ISR(TIMER1_COMPA_vect)
         st.steps[X_AXIS] = st.exec_block->steps[X_AXIS] >> st.exec_segment->amass_level;
         st.steps[Y_AXIS] = st.exec_block->steps[Y_AXIS] >> st.exec_segment->amass_level;
         st.steps[Z_AXIS] = st.exec_block->steps[Z_AXIS] >> st.exec_segment->amass_level;
+        #ifdef ENABLE_LASER_RASTER
+          st.steps_raster = st.exec_block->raster_count >> st.exec_segment->amass_level;
+        #endif
       #endif
 
       #ifdef VARIABLE_SPINDLE
+        #ifdef ENABLE_LASER_PWM_INTERPOLATION
+          // Setup a linear PWM ramp from the current output to the segment PWM for rate-adjusted
+          // laser motions. A change larger than the segment step events ramps by whole counts per
+          // step, plus the remainder by Bresenham. Set directly, if the segment has no step events.
+          st.pwm_delta = 0;
+          st.pwm_step = 0;
+          if (st.exec_block->is_pwm_rate_adjusted && st.step_count) {
+            if (st.exec_segment->spindle_pwm > st.spindle_pwm) {
+              st.pwm_delta = st.exec_segment->spindle_pwm - st.spindle_pwm;
+              st.pwm_increment = 1;
+            } else {
+              st.pwm_delta = st.spindle_pwm - st.exec_segment->spindle_pwm;
+              st.pwm_increment = -1;
+            }
+            if (st.pwm_delta >= st.step_count) {
+              st.pwm_step = st.pwm_delta/st.step_count;
+              st.pwm_delta -= st.pwm_step*st.step_count;
+            }
+            st.pwm_counter = (st.step_count >> 1);
+          } else {
+            st.spindle_pwm = st.exec_segment->spindle_pwm;
+          }
+        #else
+          st.spindle_pwm = st.exec_segment->spindle_pwm;
+        #endif
         // Set real-time spindle output as segment is loaded, just prior to the first step.
-        spindle_set_speed(st.exec_segment->spindle_pwm);
+        #ifdef ENABLE_LASER_RASTER
+          if (st.exec_block->raster_count) {
+            spindle_set_speed(RASTER_PIXEL_PWM(st.raster_pixel,st.spindle_pwm));
+          } else
+        #endif
+        spindle_set_speed(st.spindle_pwm);
       #endif
 
     } else {
       // Segment buffer empty. Shutdown.
+      #ifdef ENABLE_PERF_COUNTERS
+        // Count an underrun, if the segment buffer ran dry before the planned motion completed.
+        if (plan_get_current_block() && bit_isfalse(sys.step_control,STEP_CONTROL_END_MOTION)) {
+          perf_count_event(PERF_EVENT_SEGMENT_UNDERRUN);
+        }
+      #endif
       st_go_idle();
       #ifdef VARIABLE_SPINDLE
         // Ensure pwm is set properly upon completion of rate-controlled motion.
         if (st.exec_block->is_pwm_rate_adjusted) { spindle_set_speed(SPINDLE_PWM_OFF_VALUE); }
+        #ifdef ENABLE_LASER_RASTER
+          if (st.exec_block->raster_count) { spindle_set_speed(SPINDLE_PWM_OFF_VALUE); }
+        #endif
+        #ifdef ENABLE_LASER_PWM_INTERPOLATION
+          st.spindle_pwm = SPINDLE_PWM_OFF_VALUE; // Ramp next rate-adjusted motion up from rest.
+        #endif
       #endif
       system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
       return; // Nothing to do but exit.
@@ -452,6 +554,45 @@ ISR(TIMER1_COMPA_vect)
     else { sys_position[Z_AXIS]++; }
   }
 
+  #ifdef ENABLE_LASER_PWM_INTERPOLATION
+    // Step the laser PWM ramp by Bresenham over the segment step events.
+    if (st.pwm_delta | st.pwm_step) {
+      spindle_pwm_t pwm_change = st.pwm_step;
+      st.pwm_counter += st.pwm_delta;
+      if (st.pwm_counter >= st.exec_segment->n_step) {
+        st.pwm_counter -= st.exec_segment->n_step;
+        pwm_change++;
+      }
+      if (pwm_change) {
+        if (st.pwm_increment > 0) { st.spindle_pwm += pwm_change; }
+        else { st.spindle_pwm -= pwm_change; }
+        #ifdef ENABLE_LASER_RASTER
+          if (st.exec_block->raster_count) {
+            spindle_set_speed(RASTER_PIXEL_PWM(st.raster_pixel,st.spindle_pwm));
+          } else
+        #endif
+        spindle_set_speed(st.spindle_pwm);
+      }
+    }
+  #endif
+
+  #ifdef ENABLE_LASER_RASTER
+    // Trace raster pixel boundaries as an additional Bresenham axis and update the laser power
+    // as each new pixel is entered. The planner ensures each pixel spans at least one step.
+    if (st.exec_block->raster_count) {
+      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        st.counter_raster += st.steps_raster;
+      #else
+        st.counter_raster += st.exec_block->raster_count;
+      #endif
+      if (st.counter_raster > st.exec_block->step_event_count) {
+        st.counter_raster -= st.exec_block->step_event_count;
+        st.raster_pixel = raster_get_next_pixel();
+        spindle_set_speed(RASTER_PIXEL_PWM(st.raster_pixel,st.spindle_pwm));
+      }
+    }
+  #endif
+
   // During a homing cycle, lock out and prevent desired axes from moving.
   if (sys.state == STATE_HOMING) { 
     st.step_outbits &= sys.homing_axis_lock;
@@ -463,6 +604,23 @@ ISR(TIMER1_COMPA_vect)
   st.step_count--; // Decrement step events count
   if (st.step_count == 0) {
     // Segment is complete. Discard current segment and advance segment indexing.
+    #ifdef ENABLE_MOTION_TRACE
+      st_trace_t *trace = &st_trace_buffer[st_trace_head];
+      trace->timestamp = perf_get_ticks();
+      trace->n_step = st.exec_segment->n_step;
+      trace->cycles_per_tick = st.exec_segment->cycles_per_tick;
+      trace->st_block_index = st.exec_segment->st_block_index;
+      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        trace->amass_level = st.exec_segment->amass_level;
+      #else
+        trace->prescaler = st.exec_segment->prescaler;
+      #endif
+      #ifdef USE_LINE_NUMBERS
+        trace->line_number = st.exec_block->line_number;
+      #endif
+      if (++st_trace_head == MOTION_TRACE_SIZE) { st_trace_head = 0; }
+      if (st_trace_count < MOTION_TRACE_SIZE) { st_trace_count++; }
+    #endif
     st.exec_segment = NULL;
     if ( ++segment_buffer_tail == SEGMENT_BUFFER_SIZE) { segment_buffer_tail = 0; }
   }
@@ -594,6 +752,107 @@ void stepper_init()
 }
 
 
+#ifdef ENABLE_MOTION_TRACE
+  uint8_t st_get_trace_record(uint8_t idx, st_trace_t *record)
+  {
+    uint8_t sreg = SREG;
+    cli(); // Block the stepper ISR from writing the record while it is copied.
+    if (idx >= st_trace_count) {
+      SREG = sreg;
+      return(false);
+    }
+    uint16_t trace_idx = st_trace_head+(MOTION_TRACE_SIZE-st_trace_count)+idx; // Oldest record first.
+    if (trace_idx >= MOTION_TRACE_SIZE) { trace_idx -= MOTION_TRACE_SIZE; }
+    memcpy(record,&st_trace_buffer[trace_idx],sizeof(st_trace_t));
+    SREG = sreg;
+    return(true);
+  }
+#endif
+
+
+#ifdef ENABLE_CHECK_MODE_ESTIMATE
+  void st_estimate_reset()
+  {
+    st_estimate_seconds = 0;
+    st_estimate_cycles = 0;
+    #ifdef USE_LINE_NUMBERS
+      st_estimate_line_active = false;
+    #endif
+  }
+
+
+  float st_estimate_get_time()
+  {
+    return(st_estimate_seconds + (float)st_estimate_cycles/F_CPU);
+  }
+
+
+  // Advances the virtual clock by the given number of CPU cycles.
+  static void st_estimate_add_cycles(uint32_t cycles)
+  {
+    st_estimate_cycles += cycles;
+    while (st_estimate_cycles >= F_CPU) {
+      st_estimate_cycles -= F_CPU;
+      st_estimate_seconds++;
+    }
+  }
+
+
+  void st_estimate_add_time(float seconds)
+  {
+    uint32_t whole_seconds = trunc(seconds);
+    st_estimate_seconds += whole_seconds;
+    st_estimate_add_cycles((seconds-whole_seconds)*F_CPU);
+  }
+
+
+  #ifdef USE_LINE_NUMBERS
+    // Reports the estimated motion time of the last line, when its motion is complete.
+    static void st_estimate_report_line()
+    {
+      if (st_estimate_line_active) {
+        report_estimate_line(st_estimate_line_number,st_estimate_get_time()-st_estimate_line_start);
+        st_estimate_line_active = false;
+      }
+    }
+  #endif
+
+
+  void st_estimate_execute(uint8_t sync)
+  {
+    segment_t *segment;
+    uint32_t cycles;
+    do {
+      protocol_execute_realtime(); // Check for any run-time commands
+      if (sys.abort) { return; } // Bail, if system abort.
+      st_prep_buffer();
+      // Execute all prepped segments in place of the stepper ISR, with its exact step timing.
+      while (segment_buffer_tail != segment_buffer_head) {
+        segment = &segment_buffer[segment_buffer_tail];
+        #ifdef USE_LINE_NUMBERS
+          int32_t line_number = st_block_buffer[segment->st_block_index].line_number;
+          if (!st_estimate_line_active || (line_number != st_estimate_line_number)) {
+            st_estimate_report_line();
+            st_estimate_line_active = true;
+            st_estimate_line_number = line_number;
+            st_estimate_line_start = st_estimate_get_time();
+          }
+        #endif
+        cycles = (uint32_t)segment->n_step*segment->cycles_per_tick;
+        #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+          cycles <<= 3*(segment->prescaler-1); // Timer1 prescaler: 1, 8, or 64
+        #endif
+        st_estimate_add_cycles(cycles);
+        if ( ++segment_buffer_tail == SEGMENT_BUFFER_SIZE) { segment_buffer_tail = 0; }
+      }
+    } while (sync ? (plan_get_current_block() != NULL) : plan_check_full_buffer());
+    #ifdef USE_LINE_NUMBERS
+      if (sync) { st_estimate_report_line(); }
+    #endif
+  }
+#endif
+
+
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters()
 {
@@ -700,6 +959,9 @@ void st_prep_buffer()
         // segment buffer finishes the prepped block, but the stepper ISR is still executing it.
         st_prep_block = &st_block_buffer[prep.st_block_index];
         st_prep_block->direction_bits = pl_block->direction_bits;
+        #if (defined(ENABLE_MOTION_TRACE) || defined(ENABLE_CHECK_MODE_ESTIMATE)) && defined(USE_LINE_NUMBERS)
+          st_prep_block->line_number = pl_block->line_number;
+        #endif
         #ifdef ENABLE_DUAL_AXIS
           #if (DUAL_AXIS_SELECT == X_AXIS)
             if (st_prep_block->direction_bits & (1<<X_DIRECTION_BIT)) { 
@@ -713,12 +975,18 @@ void st_prep_buffer()
         #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
           for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = (pl_block->steps[idx] << 1); }
           st_prep_block->step_event_count = (pl_block->step_event_count << 1);
+          #ifdef ENABLE_LASER_RASTER
+            st_prep_block->raster_count = ((uint32_t)pl_block->raster_count << 1);
+          #endif
         #else
           // With AMASS enabled, simply bit-shift multiply all Bresenham data by the max AMASS
           // level, such that we never divide beyond the original data anywhere in the algorithm.
           // If the original data is divided, we can lose a step from integer roundoff.
           for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = pl_block->steps[idx] << MAX_AMASS_LEVEL; }
           st_prep_block->step_event_count = pl_block->step_event_count << MAX_AMASS_LEVEL;
+          #ifdef ENABLE_LASER_RASTER
+            st_prep_block->raster_count = (uint32_t)pl_block->raster_count << MAX_AMASS_LEVEL;
+          #endif
         #endif
 
         // Initialize segment buffer data for generating the segments.
@@ -1049,6 +1317,9 @@ void st_prep_buffer()
     // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
     segment_buffer_head = segment_next_head;
     if ( ++segment_next_head == SEGMENT_BUFFER_SIZE ) { segment_next_head = 0; }
+    #ifdef ENABLE_PERF_COUNTERS
+      perf_count[PERF_COUNT_SEGMENT]++;
+    #endif
 
     // Update the appropriate planner and segment data.
     pl_block->millimeters = mm_remaining;
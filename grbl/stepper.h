@@ -56,4 +56,45 @@ void st_update_plan_block_parameters();
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+#ifdef ENABLE_CHECK_MODE_ESTIMATE
+  // Clears the check mode estimator virtual clock.
+  void st_estimate_reset();
+
+  // Returns the virtual clock time in seconds.
+  float st_estimate_get_time();
+
+  // Advances the virtual clock by the given time in seconds. Used for dwells.
+  void st_estimate_add_time(float seconds);
+
+  // Executes buffered motions on the virtual clock in check mode, in place of the stepper ISR. Runs
+  // until a planner block is free or, with sync set, until all buffered motions are complete.
+  void st_estimate_execute(uint8_t sync);
+#endif
+
+#ifdef ENABLE_MOTION_TRACE
+  #ifndef MOTION_TRACE_SIZE
+    #define MOTION_TRACE_SIZE 16
+  #endif
+
+  // Motion trace record of an executed step segment.
+  typedef struct {
+    uint32_t timestamp;       // Perf timer ticks at segment completion
+    uint16_t n_step;          // Segment step events
+    uint16_t cycles_per_tick; // Segment step rate in stepper timer cycles per ISR tick
+    uint8_t st_block_index;   // Stepper block data index of the segment
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      uint8_t amass_level;    // Segment AMASS level
+    #else
+      uint8_t prescaler;      // Segment stepper timer prescaler
+    #endif
+    #ifdef USE_LINE_NUMBERS
+      int32_t line_number;    // Line number of the segment planner block
+    #endif
+  } st_trace_t;
+
+  // Copies the motion trace record of the given index, oldest first. Returns false, if past the
+  // last recorded segment.
+  uint8_t st_get_trace_record(uint8_t idx, st_trace_t *record);
+#endif
+
 #endif
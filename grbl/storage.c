@@ -0,0 +1,319 @@
+/*
+  storage.c - Local program storage and execution
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_PROGRAM_STORAGE
+
+static uint8_t storage_state;
+static uint8_t storage_program; // Number of the open program.
+static uint32_t storage_line_number; // Lines read from the running program.
+static uint32_t storage_resume_line; // First line of the running program to be executed.
+static char storage_line[LINE_BUFFER_SIZE]; // Running program line. The serial line buffer stays free.
+#ifdef ENABLE_PERF_COUNTERS
+  static uint32_t storage_rate_line; // Line number and time at the last line rate update.
+  static uint32_t storage_rate_ticks;
+#endif
+
+
+void storage_reset()
+{
+  if (storage_state != STORAGE_IDLE) { storage_device_close(); }
+  storage_state = STORAGE_IDLE;
+}
+
+
+uint8_t storage_get_state() { return(storage_state); }
+uint8_t storage_get_program() { return(storage_program); }
+uint32_t storage_get_line_number() { return(storage_line_number); }
+
+
+#ifdef ENABLE_PERF_COUNTERS
+  float storage_get_line_rate()
+  {
+    uint32_t ticks = perf_get_ticks();
+    float rate = 0.0;
+    if (ticks != storage_rate_ticks) {
+      rate = (storage_line_number-storage_rate_line)/((ticks-storage_rate_ticks)*(PERF_US_PER_TICK*1e-6));
+    }
+    storage_rate_line = storage_line_number;
+    storage_rate_ticks = ticks;
+    return(rate);
+  }
+#endif
+
+
+// Reads an integer command value up to the given maximum.
+static uint8_t storage_read_integer(char *line, uint8_t *char_counter, uint32_t max_value, uint32_t *value)
+{
+  float number;
+  if (!read_float(line, char_counter, &number)) { return(STATUS_BAD_NUMBER_FORMAT); }
+  if (number < 0.0) { return(STATUS_NEGATIVE_VALUE); }
+  if ((number != trunc(number)) || (number > max_value)) { return(STATUS_INVALID_STATEMENT); }
+  *value = number;
+  return(STATUS_OK);
+}
+
+
+// Ends the running program and reports the line it ended on, with the status of that line.
+static void storage_stop(uint8_t status_code)
+{
+  storage_device_close();
+  storage_state = STORAGE_IDLE;
+  report_storage_run_end(storage_program, storage_line_number, status_code);
+}
+
+
+uint8_t storage_execute_command(char *line)
+{
+  uint8_t char_counter = 4;
+  uint32_t value;
+  uint8_t status_code;
+
+  if (line[2] == 0) { // List stored programs. Allowed in any state.
+    uint8_t program = 0;
+    do {
+      if (storage_device_size(program, &value)) { report_storage_program(program, value); }
+    } while (++program != 0);
+    return(STATUS_OK);
+  }
+
+  if (line[2] == 'C') { // Close an uploaded program.
+    if (line[3] != 0) { return(STATUS_INVALID_STATEMENT); }
+    if (storage_state != STORAGE_WRITING) { return(STATUS_INVALID_STATEMENT); }
+    storage_device_close();
+    storage_state = STORAGE_IDLE;
+    return(STATUS_OK);
+  }
+
+  // Remaining commands are given a program number, as in '$FR=3'.
+  if (line[3] != '=') { return(STATUS_INVALID_STATEMENT); }
+  if (storage_state != STORAGE_IDLE) { return(STATUS_STORAGE_BUSY); }
+  status_code = storage_read_integer(line, &char_counter, 255, &value);
+  if (status_code) { return(status_code); }
+  storage_program = value;
+  switch (line[2]) {
+    case 'W': // Upload a program. Following lines are stored until '$FC'. [IDLE/ALARM]
+      if (line[char_counter] != 0) { return(STATUS_INVALID_STATEMENT); }
+      if (!storage_device_open(storage_program, true)) { return(STATUS_STORAGE_FAILED); }
+      storage_state = STORAGE_WRITING;
+      break;
+    case 'R': // Run a program, or resume it from a line, as in '$FR=3,120'. [IDLE/CHECK]
+      storage_resume_line = 1;
+      if (line[char_counter] == ',') {
+        char_counter++;
+        status_code = storage_read_integer(line, &char_counter, 0xffffffff, &value);
+        if (status_code) { return(status_code); }
+        storage_resume_line = value;
+      }
+      if (line[char_counter] != 0) { return(STATUS_INVALID_STATEMENT); }
+      if (sys.state & ~STATE_CHECK_MODE) { return(STATUS_IDLE_ERROR); }
+      if (!storage_device_open(storage_program, false)) { return(STATUS_STORAGE_FAILED); }
+      storage_state = STORAGE_RUNNING;
+      storage_line_number = 0;
+      #ifdef ENABLE_PERF_COUNTERS
+        storage_get_line_rate(); // Start the line rate measurement.
+      #endif
+      break;
+    case 'D': // Delete a program. [IDLE/ALARM]
+      if (line[char_counter] != 0) { return(STATUS_INVALID_STATEMENT); }
+      storage_device_delete(storage_program);
+      break;
+    default: return(STATUS_INVALID_STATEMENT);
+  }
+  return(STATUS_OK);
+}
+
+
+uint8_t storage_input_line(char *line)
+{
+  if (storage_state == STORAGE_RUNNING) { return(STATUS_STORAGE_BUSY); }
+  #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+    protocol_buffer_synchronize();
+  #endif
+  uint8_t idx = 0;
+  do {
+    if (!storage_device_write(line[idx] ? line[idx] : '\n')) {
+      // Program doesn't fit. Discard it, rather than keep a truncated program.
+      storage_device_close();
+      storage_device_delete(storage_program);
+      storage_state = STORAGE_IDLE;
+      return(STATUS_STORAGE_FAILED);
+    }
+  } while (line[idx++] != 0);
+  return(STATUS_OK);
+}
+
+
+// Executes a line of the running program, as the protocol main loop executes a streamed line.
+static uint8_t storage_execute_line(uint8_t line_flags)
+{
+  if (line_flags & LINE_FLAG_OVERFLOW) { return(STATUS_OVERFLOW); }
+  if (storage_line[0] == 0) { return(STATUS_OK); } // Empty or comment line.
+  if (storage_line[0] == '$') { return(STATUS_INVALID_STATEMENT); } // System commands can't be stored.
+  if (sys.state & (STATE_ALARM | STATE_JOG)) { return(STATUS_SYSTEM_GC_LOCK); }
+  #ifdef ENABLE_SUBPROGRAMS
+    if ((storage_line[0] == 'O') || subprogram_is_recording()) { return(subprogram_execute_line(storage_line)); }
+  #endif
+  return(gc_execute_line(storage_line));
+}
+
+
+// Reads the next line of the running program, with the same filtering as serial input, and
+// executes it. Stops the program at its end or at the first error.
+// NOTE: When resuming, the lines before the resume line are executed in check mode, without any
+// motion, spindle, or coolant, to restore the modal state, offsets, and programmed position they
+// leave behind. The spindle and coolant of that state are restored before the resume line.
+void storage_execute_next_line()
+{
+  uint8_t char_counter = 0;
+  uint8_t line_flags = 0;
+  // The lines before the resume line are only checked, and the spindle and coolant are synced at
+  // the resume line. Both wait for the idle state, for example while the safety door is open,
+  // without reading the line. In check mode, every line is only checked anyway.
+  if ((storage_line_number < storage_resume_line) && (storage_resume_line > 1) &&
+      (sys.state != STATE_IDLE) && (sys.state != STATE_CHECK_MODE)) { return; }
+  int16_t c = storage_device_read();
+  if (c == STORAGE_END_OF_PROGRAM) {
+    storage_stop(STATUS_OK);
+    return;
+  }
+  while ((c != '\n') && (c != STORAGE_END_OF_PROGRAM)) {
+    protocol_filter_char(storage_line, &char_counter, &line_flags, c);
+    c = storage_device_read();
+  }
+  storage_line[char_counter] = 0;
+  storage_line_number++;
+
+  uint8_t status_code;
+  if (storage_line_number < storage_resume_line) {
+    uint8_t state = sys.state; // Idle or check mode.
+    sys.state = STATE_CHECK_MODE;
+    status_code = storage_execute_line(line_flags);
+    protocol_buffer_synchronize(); // Complete any pending arc segments, while still in check mode.
+    if (sys.state == STATE_CHECK_MODE) { sys.state = state; }
+    #ifdef ENABLE_CHECK_MODE_ESTIMATE
+      plan_sync_position(); // The estimator planned the checked motions.
+    #endif
+  } else {
+    if ((storage_line_number == storage_resume_line) && (storage_resume_line > 1) && (sys.state == STATE_IDLE)) {
+      spindle_sync(gc_state.modal.spindle, gc_state.spindle_speed);
+      coolant_sync(gc_state.modal.coolant);
+    }
+    status_code = storage_execute_line(line_flags);
+  }
+  if (status_code) { storage_stop(status_code); }
+}
+
+
+#ifdef __AVR__
+
+// EEPROM storage device. Each program slot starts with the program length, which is erased for an
+// empty slot. The length is written when an uploaded program is closed.
+#define STORAGE_EEPROM_SLOT_SIZE ((E2END+1-STORAGE_EEPROM_ADDR)/STORAGE_EEPROM_PROGRAMS)
+#define STORAGE_EEPROM_EMPTY 0xffff
+
+static uint16_t storage_device_slot; // Address of the open program slot.
+static uint16_t storage_device_addr; // Address of the next character.
+static uint16_t storage_device_end; // End of the open program, or of its slot while writing.
+static uint8_t storage_device_writing;
+
+
+static uint16_t storage_eeprom_slot(uint8_t program)
+{
+  return(STORAGE_EEPROM_ADDR+program*STORAGE_EEPROM_SLOT_SIZE);
+}
+
+
+static uint16_t storage_eeprom_length(uint16_t slot)
+{
+  uint16_t length = eeprom_get_char(slot) | (eeprom_get_char(slot+1) << 8);
+  if (length > STORAGE_EEPROM_SLOT_SIZE-2) { return(STORAGE_EEPROM_EMPTY); } // Erased or invalid.
+  return(length);
+}
+
+
+static void storage_eeprom_write_length(uint16_t slot, uint16_t length)
+{
+  eeprom_put_char(slot, length & 0xff);
+  eeprom_put_char(slot+1, length >> 8);
+}
+
+
+uint8_t storage_device_open(uint8_t program, uint8_t write)
+{
+  if (program >= STORAGE_EEPROM_PROGRAMS) { return(false); }
+  storage_device_slot = storage_eeprom_slot(program);
+  storage_device_addr = storage_device_slot+2;
+  storage_device_writing = write;
+  if (write) {
+    storage_eeprom_write_length(storage_device_slot, STORAGE_EEPROM_EMPTY); // Until closed.
+    storage_device_end = storage_device_slot+STORAGE_EEPROM_SLOT_SIZE;
+  } else {
+    uint16_t length = storage_eeprom_length(storage_device_slot);
+    if (length == STORAGE_EEPROM_EMPTY) { return(false); }
+    storage_device_end = storage_device_addr+length;
+  }
+  return(true);
+}
+
+
+int16_t storage_device_read()
+{
+  if (storage_device_addr >= storage_device_end) { return(STORAGE_END_OF_PROGRAM); }
+  return(eeprom_get_char(storage_device_addr++));
+}
+
+
+uint8_t storage_device_write(uint8_t c)
+{
+  if (storage_device_addr >= storage_device_end) { return(false); }
+  eeprom_put_char(storage_device_addr++, c);
+  return(true);
+}
+
+
+void storage_device_close()
+{
+  if (storage_device_writing) {
+    storage_eeprom_write_length(storage_device_slot, storage_device_addr-(storage_device_slot+2));
+    storage_device_writing = false;
+  }
+}
+
+
+uint8_t storage_device_size(uint8_t program, uint32_t *size)
+{
+  if (program >= STORAGE_EEPROM_PROGRAMS) { return(false); }
+  uint16_t length = storage_eeprom_length(storage_eeprom_slot(program));
+  if (length == STORAGE_EEPROM_EMPTY) { return(false); }
+  *size = length;
+  return(true);
+}
+
+
+void storage_device_delete(uint8_t program)
+{
+  if (program < STORAGE_EEPROM_PROGRAMS) { storage_eeprom_write_length(storage_eeprom_slot(program), STORAGE_EEPROM_EMPTY); }
+}
+
+#endif
+
+#endif
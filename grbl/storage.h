@@ -0,0 +1,75 @@
+/*
+  storage.h - Local program storage and execution
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef storage_h
+#define storage_h
+
+// EEPROM storage device layout. Programs are kept in equal slots of the EEPROM beyond the 1KB used
+// by Grbl, so this device requires a processor with a larger EEPROM, such as the Atmega2560.
+#ifndef STORAGE_EEPROM_ADDR
+  #define STORAGE_EEPROM_ADDR 1024U
+#endif
+#ifndef STORAGE_EEPROM_PROGRAMS
+  #define STORAGE_EEPROM_PROGRAMS 3
+#endif
+
+// Define program storage states.
+#define STORAGE_IDLE 0
+#define STORAGE_WRITING 1 // Storing uploaded lines
+#define STORAGE_RUNNING 2 // Executing a stored program
+
+// Returned by the storage device at the end of a program.
+#define STORAGE_END_OF_PROGRAM -1
+
+// Closes the open program and stops a running one. Called by the system abort/initialization routine.
+void storage_reset();
+
+// Returns the program storage state.
+uint8_t storage_get_state();
+
+// Executes a '$F' program storage command.
+uint8_t storage_execute_command(char *line);
+
+// Stores a line of an uploaded program. Otherwise, locks out g-code from the serial port while a
+// stored program runs.
+uint8_t storage_input_line(char *line);
+
+// Reads and executes the next line of the running program. Called by the main loop.
+void storage_execute_next_line();
+
+// Returns the number and current line of the running program.
+uint8_t storage_get_program();
+uint32_t storage_get_line_number();
+
+#ifdef ENABLE_PERF_COUNTERS
+  // Returns the lines per second executed from storage since the last call. Used by status reports.
+  float storage_get_line_rate();
+#endif
+
+// Storage device interface. Only one program is open at a time, until it is closed. Implemented for
+// the larger EEPROM of AVR targets and by the host simulator, which keeps programs as files.
+uint8_t storage_device_open(uint8_t program, uint8_t write); // Returns false, if it can't be opened.
+int16_t storage_device_read(); // Returns the next character, or STORAGE_END_OF_PROGRAM.
+uint8_t storage_device_write(uint8_t c); // Returns false, if the program doesn't fit.
+void storage_device_close();
+uint8_t storage_device_size(uint8_t program, uint32_t *size); // Returns false, if not stored.
+void storage_device_delete(uint8_t program);
+
+#endif
@@ -0,0 +1,337 @@
+/*
+  subprogram.c - O-word subprogram storage and execution
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef ENABLE_SUBPROGRAMS
+
+// Define O-word statement keywords. An end keyword directly follows its start keyword.
+#define SUBPROGRAM_SUB 0
+#define SUBPROGRAM_ENDSUB 1
+#define SUBPROGRAM_REPEAT 2
+#define SUBPROGRAM_ENDREPEAT 3
+#define SUBPROGRAM_CALL 4
+
+// The store is a list of lines, each as a two byte subprogram number, a length byte, and the line
+// characters with a checksum. The list ends at an erased subprogram number.
+#define SUBPROGRAM_NONE 0xffff
+#define SUBPROGRAM_LINE_HEADER 3
+#define SUBPROGRAM_LINE_SIZE(length) (SUBPROGRAM_LINE_HEADER+(length)+1)
+#define SUBPROGRAM_STORE_END (EEPROM_ADDR_SUBPROGRAM+SUBPROGRAM_STORE_SIZE)
+
+static uint16_t subprogram_recording; // Number of the subprogram being defined. SUBPROGRAM_NONE if none.
+static uint8_t subprogram_end_keyword; // Keyword that ends the definition.
+static uint16_t subprogram_repeat_count; // Executions of a REPEAT definition, once it ends.
+static uint16_t subprogram_repeat_number; // Number of the top-level REPEAT block being defined or executed.
+static uint8_t subprogram_repeat_stored; // Set while the REPEAT block body is in the store.
+static uint16_t subprogram_store_end; // Address of the end of the store, while defining.
+static uint16_t subprogram_open_repeat[SUBPROGRAM_MAX_DEPTH-1]; // REPEAT numbers open in the definition.
+static uint8_t subprogram_open_repeats;
+
+
+static uint16_t subprogram_delete(uint16_t number);
+
+
+void subprogram_reset()
+{
+  subprogram_recording = SUBPROGRAM_NONE;
+  if (subprogram_repeat_stored) {
+    // Free the body of a REPEAT block abandoned by the reset.
+    subprogram_repeat_stored = false;
+    subprogram_delete(subprogram_repeat_number);
+  }
+}
+
+
+uint8_t subprogram_is_recording()
+{
+  return(subprogram_recording != SUBPROGRAM_NONE);
+}
+
+
+// Reads the header of the stored line at addr. Returns false at the end of the store, which is also
+// assumed for a header that doesn't describe a valid line.
+static uint8_t subprogram_read_header(uint16_t addr, uint16_t *number, uint8_t *length)
+{
+  if (addr+SUBPROGRAM_LINE_HEADER > SUBPROGRAM_STORE_END) { return(false); }
+  *number = eeprom_get_char(addr) | (eeprom_get_char(addr+1) << 8);
+  *length = eeprom_get_char(addr+2);
+  if ((*number == SUBPROGRAM_NONE) || (*length >= LINE_BUFFER_SIZE)) { return(false); }
+  if (addr+SUBPROGRAM_LINE_SIZE(*length) > SUBPROGRAM_STORE_END) { return(false); }
+  return(true);
+}
+
+
+static void subprogram_write_end(uint16_t addr)
+{
+  if (addr+2 <= SUBPROGRAM_STORE_END) {
+    eeprom_put_char(addr, 0xff);
+    eeprom_put_char(addr+1, 0xff);
+  }
+}
+
+
+// Deletes the stored lines of a subprogram, by moving the lines that follow them down the store.
+// Returns the new end of the store.
+static uint16_t subprogram_delete(uint16_t number)
+{
+  uint16_t addr = EEPROM_ADDR_SUBPROGRAM;
+  uint16_t dest = EEPROM_ADDR_SUBPROGRAM;
+  uint16_t line_number;
+  uint8_t length, idx;
+  while (subprogram_read_header(addr, &line_number, &length)) {
+    if (line_number != number) {
+      if (dest != addr) {
+        for (idx=0; idx<SUBPROGRAM_LINE_SIZE(length); idx++) { eeprom_put_char(dest+idx, eeprom_get_char(addr+idx)); }
+      }
+      dest += SUBPROGRAM_LINE_SIZE(length);
+    }
+    addr += SUBPROGRAM_LINE_SIZE(length);
+  }
+  subprogram_write_end(dest);
+  return(dest);
+}
+
+
+// Deletes the stored body of the top-level REPEAT block, once executed or abandoned.
+static void subprogram_delete_repeat()
+{
+  #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+    protocol_buffer_synchronize(); // The repeated lines may be executing.
+  #endif
+  subprogram_repeat_stored = false;
+  subprogram_delete(subprogram_repeat_number);
+}
+
+
+// Appends a line of the subprogram being defined to the store.
+static uint8_t subprogram_store_line(char *line)
+{
+  uint8_t length = strlen(line);
+  if (subprogram_store_end+SUBPROGRAM_LINE_SIZE(length) > SUBPROGRAM_STORE_END) { return(STATUS_GCODE_SUBPROGRAM_STORE_FULL); }
+  #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+    protocol_buffer_synchronize(); // Lines before the definition may be executing.
+  #endif
+  eeprom_put_char(subprogram_store_end, subprogram_recording & 0xff);
+  eeprom_put_char(subprogram_store_end+1, subprogram_recording >> 8);
+  eeprom_put_char(subprogram_store_end+2, length);
+  memcpy_to_eeprom_with_checksum(subprogram_store_end+SUBPROGRAM_LINE_HEADER, line, length);
+  subprogram_store_end += SUBPROGRAM_LINE_SIZE(length);
+  subprogram_write_end(subprogram_store_end);
+  return(STATUS_OK);
+}
+
+
+// Returns true and advances char_counter past the keyword, if the line continues with it.
+static uint8_t subprogram_match(char *line, uint8_t *char_counter, const char *keyword)
+{
+  uint8_t idx = *char_counter;
+  char c;
+  while ((c = pgm_read_byte(keyword++))) {
+    if (line[idx++] != c) { return(false); }
+  }
+  *char_counter = idx;
+  return(true);
+}
+
+
+// Reads a non-negative integer value for a subprogram number or repeat count.
+static uint8_t subprogram_read_integer(char *line, uint8_t *char_counter, uint16_t *value)
+{
+  float number;
+  if (!read_float(line, char_counter, &number)) { return(STATUS_BAD_NUMBER_FORMAT); }
+  if (number < 0.0) { return(STATUS_NEGATIVE_VALUE); }
+  if (number != trunc(number)) { return(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); }
+  if (number >= SUBPROGRAM_NONE) { return(STATUS_GCODE_MAX_VALUE_EXCEEDED); }
+  *value = number;
+  return(STATUS_OK);
+}
+
+
+// Parses an O-word statement, such as 'O100CALL', into its subprogram number and keyword. A REPEAT
+// keyword is followed by its count, optionally in brackets, as in 'O100REPEAT[5]'.
+static uint8_t subprogram_parse(char *line, uint16_t *number, uint8_t *keyword, uint16_t *count)
+{
+  uint8_t char_counter = 1; // Skip 'O'
+  uint8_t status_code = subprogram_read_integer(line, &char_counter, number);
+  if (status_code) { return(status_code); }
+  if (subprogram_match(line, &char_counter, PSTR("SUB"))) { *keyword = SUBPROGRAM_SUB; }
+  else if (subprogram_match(line, &char_counter, PSTR("ENDSUB"))) { *keyword = SUBPROGRAM_ENDSUB; }
+  else if (subprogram_match(line, &char_counter, PSTR("REPEAT"))) {
+    *keyword = SUBPROGRAM_REPEAT;
+    uint8_t bracket = (line[char_counter] == '[');
+    char_counter += bracket;
+    status_code = subprogram_read_integer(line, &char_counter, count);
+    if (status_code) { return(status_code); }
+    if (bracket && (line[char_counter++] != ']')) { return(STATUS_INVALID_STATEMENT); }
+  }
+  else if (subprogram_match(line, &char_counter, PSTR("ENDREPEAT"))) { *keyword = SUBPROGRAM_ENDREPEAT; }
+  else if (subprogram_match(line, &char_counter, PSTR("CALL"))) { *keyword = SUBPROGRAM_CALL; }
+  else { return(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported O-word statement]
+  if (line[char_counter] != 0) { return(STATUS_GCODE_UNUSED_WORDS); } // [Call arguments not supported]
+  return(STATUS_OK);
+}
+
+
+static uint8_t subprogram_call(uint16_t number, char *line, uint8_t depth);
+
+
+// Executes the stored lines of a subprogram in order, from the store address addr, through the line
+// buffer. Stored calls and REPEAT blocks nest up to SUBPROGRAM_MAX_DEPTH deep. In a REPEAT block, it
+// stops after the ENDREPEAT of the repeat number and leaves addr past it. Without execute, the lines
+// of the block are only skipped. Stops at the first error or a system abort.
+// NOTE: Only the store address of the next line is kept per level, so the nested calls and repeats
+// share the line buffer and cost little stack.
+static uint8_t subprogram_run(uint16_t number, uint16_t *addr, char *line, uint8_t depth, uint16_t repeat,
+                              uint8_t execute)
+{
+  if (depth > SUBPROGRAM_MAX_DEPTH) { return(STATUS_GCODE_SUBPROGRAM_NESTING); }
+  uint16_t line_number;
+  uint8_t length;
+  while (subprogram_read_header(*addr, &line_number, &length)) {
+    uint16_t line_addr = *addr;
+    *addr += SUBPROGRAM_LINE_SIZE(length);
+    if (line_number != number) { continue; }
+    if (!(memcpy_from_eeprom_with_checksum(line, line_addr+SUBPROGRAM_LINE_HEADER, length))) { return(STATUS_SETTING_READ_FAIL); }
+    line[length] = 0;
+    uint8_t status_code = STATUS_OK;
+    if (line[0] == 'O') {
+      uint16_t o_number, count;
+      uint8_t keyword;
+      status_code = subprogram_parse(line, &o_number, &keyword, &count);
+      if (status_code) { return(status_code); }
+      if ((keyword == SUBPROGRAM_ENDREPEAT) && (o_number == repeat)) { return(STATUS_OK); }
+      if (!execute) { continue; }
+      if (keyword == SUBPROGRAM_CALL) {
+        status_code = subprogram_call(o_number, line, depth+1);
+      } else if (keyword == SUBPROGRAM_REPEAT) {
+        // Execute the block count times, from the line after the REPEAT, or skip it for a zero count.
+        uint16_t block_addr = *addr;
+        if (count == 0) { status_code = subprogram_run(number, addr, line, depth+1, o_number, false); }
+        for (; count > 0; count--) {
+          *addr = block_addr;
+          status_code = subprogram_run(number, addr, line, depth+1, o_number, true);
+          if (status_code || sys.abort) { break; }
+        }
+      }
+    } else if (execute) {
+      status_code = gc_execute_line(line);
+    }
+    if (status_code) { return(status_code); }
+    if (sys.abort) { return(STATUS_OK); }
+  }
+  if (repeat != SUBPROGRAM_NONE) { return(STATUS_GCODE_SUBPROGRAM_NESTING); } // [ENDREPEAT missing]
+  return(STATUS_OK);
+}
+
+
+// Executes the stored lines of a subprogram, from its first line.
+static uint8_t subprogram_call(uint16_t number, char *line, uint8_t depth)
+{
+  uint16_t addr = EEPROM_ADDR_SUBPROGRAM;
+  uint16_t line_number;
+  uint8_t length;
+  while (subprogram_read_header(addr, &line_number, &length)) {
+    if (line_number == number) { return(subprogram_run(number, &addr, line, depth, SUBPROGRAM_NONE, true)); }
+    addr += SUBPROGRAM_LINE_SIZE(length);
+  }
+  return(STATUS_GCODE_UNDEFINED_SUBPROGRAM);
+}
+
+
+uint8_t subprogram_execute_line(char *line)
+{
+  uint16_t number, count = 0;
+  uint8_t keyword;
+  uint8_t status_code;
+
+  if (subprogram_recording != SUBPROGRAM_NONE) {
+    // Store the line, unless it ends the definition. Calls and REPEAT blocks may be nested in a
+    // definition. Each block needs its own number, and must end before the definition ends.
+    // Any error ends the definition, with the lines stored so far.
+    status_code = STATUS_OK;
+    if (line[0] == 'O') {
+      status_code = subprogram_parse(line, &number, &keyword, &count);
+      if (status_code == STATUS_OK) {
+        if ((number == subprogram_recording) && (keyword == subprogram_end_keyword) && !subprogram_open_repeats) {
+          subprogram_recording = SUBPROGRAM_NONE;
+          if (keyword == SUBPROGRAM_ENDSUB) { return(STATUS_OK); }
+          // Execute the repeat body, now that it's stored. Then free its store, as only SUB
+          // definitions are kept. On a system abort, the reset frees it.
+          for (; subprogram_repeat_count > 0; subprogram_repeat_count--) {
+            status_code = subprogram_call(number, line, 1);
+            if (status_code || sys.abort) { break; }
+          }
+          if (!sys.abort) { subprogram_delete_repeat(); }
+          return(status_code);
+        }
+        if (keyword == SUBPROGRAM_REPEAT) {
+          uint8_t in_use = (number == subprogram_recording);
+          uint8_t idx = subprogram_open_repeats;
+          while (idx--) { if (subprogram_open_repeat[idx] == number) { in_use = true; } }
+          if (in_use || (subprogram_open_repeats == SUBPROGRAM_MAX_DEPTH-1)) {
+            status_code = STATUS_GCODE_SUBPROGRAM_NESTING; // [Number in use or nested too deeply]
+          } else {
+            subprogram_open_repeat[subprogram_open_repeats++] = number;
+          }
+        } else if (keyword == SUBPROGRAM_ENDREPEAT) {
+          if (subprogram_open_repeats && (subprogram_open_repeat[subprogram_open_repeats-1] == number)) {
+            subprogram_open_repeats--;
+          } else {
+            status_code = STATUS_GCODE_SUBPROGRAM_NESTING; // [ENDREPEAT without its REPEAT]
+          }
+        } else if (keyword != SUBPROGRAM_CALL) {
+          status_code = STATUS_GCODE_SUBPROGRAM_NESTING;
+        }
+      }
+    }
+    if (status_code == STATUS_OK) { status_code = subprogram_store_line(line); }
+    if (status_code) {
+      subprogram_recording = SUBPROGRAM_NONE;
+      if (subprogram_repeat_stored) { subprogram_delete_repeat(); }
+    }
+    return(status_code);
+  }
+
+  status_code = subprogram_parse(line, &number, &keyword, &count);
+  if (status_code) { return(status_code); }
+  switch (keyword) {
+    case SUBPROGRAM_SUB: case SUBPROGRAM_REPEAT:
+      // Start a definition. It replaces any subprogram stored with the same number.
+      #ifdef FORCE_BUFFER_SYNC_DURING_EEPROM_WRITE
+        protocol_buffer_synchronize();
+      #endif
+      subprogram_store_end = subprogram_delete(number);
+      subprogram_recording = number;
+      subprogram_end_keyword = keyword+1;
+      subprogram_repeat_count = count;
+      subprogram_open_repeats = 0;
+      if (keyword == SUBPROGRAM_REPEAT) {
+        subprogram_repeat_number = number;
+        subprogram_repeat_stored = true;
+      }
+      return(STATUS_OK);
+    case SUBPROGRAM_CALL:
+      return(subprogram_call(number, line, 1));
+  }
+  return(STATUS_GCODE_SUBPROGRAM_NESTING); // [End without definition]
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+  subprogram.h - O-word subprogram storage and execution
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef subprogram_h
+#define subprogram_h
+
+// Size of the EEPROM subprogram store, which starts at EEPROM_ADDR_SUBPROGRAM. By default, it fills
+// the free space up to the coordinate parameters.
+#ifndef SUBPROGRAM_STORE_SIZE
+  #define SUBPROGRAM_STORE_SIZE (EEPROM_ADDR_PARAMETERS-EEPROM_ADDR_SUBPROGRAM)
+#endif
+
+// Number of nested subprogram calls allowed, counting the call sent to Grbl.
+#ifndef SUBPROGRAM_MAX_DEPTH
+  #define SUBPROGRAM_MAX_DEPTH 4
+#endif
+
+// Abandons an unfinished subprogram definition. Called by the system abort/initialization routine.
+void subprogram_reset();
+
+// Returns true while the lines of a subprogram definition are being stored.
+uint8_t subprogram_is_recording();
+
+// Executes an O-word statement, or stores a line of the subprogram being defined.
+uint8_t subprogram_execute_line(char *line);
+
+#endif
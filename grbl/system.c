@@ -125,6 +125,17 @@ uint8_t system_execute_line(char *line)
   uint8_t char_counter = 1;
   uint8_t helper_var = 0; // Helper variable
   float parameter, value;
+  #ifdef ENABLE_PROGRAM_STORAGE
+    // While a stored program runs, only allow the reports and the storage and performance counter
+    // commands. The program may be briefly idle between its lines.
+    if (storage_get_state() == STORAGE_RUNNING) {
+      switch (line[1]) {
+        case 0: case '$': case '#': case 'G': case 'F': case 'P': break;
+        case 'I': if (line[2] != 0) { return(STATUS_STORAGE_BUSY); } break; // Build info writes are blocked.
+        default: return(STATUS_STORAGE_BUSY);
+      }
+    }
+  #endif
   switch( line[char_counter] ) {
     case 0 : report_grbl_help(); break;
     case 'J' : // Jogging
@@ -133,12 +144,41 @@ uint8_t system_execute_line(char *line)
       if(line[2] != '=') { return(STATUS_INVALID_STATEMENT); }
       return(gc_execute_line(line)); // NOTE: $J= is ignored inside g-code parser and used to detect jog motions.
       break;
+    #ifdef ENABLE_LASER_RASTER
+      case 'L' : // Laser raster scanline
+        // Executes as a g-code motion. Block if in alarm or jog mode.
+        if (sys.state & (STATE_ALARM | STATE_JOG)) { return(STATUS_SYSTEM_GC_LOCK); }
+        return(raster_execute_line(line));
+        break;
+    #endif
+    #ifdef ENABLE_PROGRAM_STORAGE
+      case 'F' : // List, upload, run, or delete stored programs.
+        return(storage_execute_command(line));
+        break;
+    #endif
+    #ifdef ENABLE_PERF_COUNTERS
+      case 'P' : // Print or reset performance counters. Allowed in any state.
+        if (line[2] == 0) {
+          #ifdef ENABLE_CHUNKED_REPORTS
+            report_chunked_start(REPORT_CHUNK_PERF_COUNTERS,line);
+          #else
+            report_perf_counters();
+          #endif
+        } else if ((line[2] == 'R') && (line[3] == 0)) {
+          perf_reset();
+        } else { return(STATUS_INVALID_STATEMENT); }
+        break;
+    #endif
     case '$': case 'G': case 'C': case 'X':
       if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
       switch( line[1] ) {
         case '$' : // Prints Grbl settings
-          if ( sys.state & (STATE_CYCLE | STATE_HOLD) ) { return(STATUS_IDLE_ERROR); } // Block during cycle. Takes too long to print.
-          else { report_grbl_settings(); }
+          #ifdef ENABLE_CHUNKED_REPORTS
+            report_chunked_start(REPORT_CHUNK_SETTINGS,line); // Doesn't block. Allowed during cycle.
+          #else
+            if ( sys.state & (STATE_CYCLE | STATE_HOLD) ) { return(STATUS_IDLE_ERROR); } // Block during cycle. Takes too long to print.
+            else { report_grbl_settings(); }
+          #endif
           break;
         case 'G' : // Prints gcode parser state
           // TODO: Move this to realtime commands for GUIs to request this data during suspend-state.
@@ -149,10 +189,18 @@ uint8_t system_execute_line(char *line)
           // is idle and ready, regardless of alarm locks. This is mainly to keep things
           // simple and consistent.
           if ( sys.state == STATE_CHECK_MODE ) {
+            #ifdef ENABLE_CHECK_MODE_ESTIMATE
+              protocol_buffer_synchronize(); // Complete the estimate of any buffered motions.
+              if (sys.abort) { return(STATUS_OK); }
+              report_estimate_total(st_estimate_get_time());
+            #endif
             mc_reset();
             report_feedback_message(MESSAGE_DISABLED);
           } else {
             if (sys.state) { return(STATUS_IDLE_ERROR); } // Requires no alarm mode.
+            #ifdef ENABLE_CHECK_MODE_ESTIMATE
+              st_estimate_reset();
+            #endif
             sys.state = STATE_CHECK_MODE;
             report_feedback_message(MESSAGE_ENABLED);
           }
@@ -170,11 +218,20 @@ uint8_t system_execute_line(char *line)
       break;
     default :
       // Block any system command that requires the state as IDLE/ALARM. (i.e. EEPROM, homing)
-      if ( !(sys.state == STATE_IDLE || sys.state == STATE_ALARM) ) { return(STATUS_IDLE_ERROR); }
+      if ( !(sys.state == STATE_IDLE || sys.state == STATE_ALARM) ) {
+        #ifdef ENABLE_CHUNKED_REPORTS
+          if (line[1] != '#') // Chunked '$#' report doesn't block. Allowed in any state.
+        #endif
+        { return(STATUS_IDLE_ERROR); }
+      }
       switch( line[1] ) {
         case '#' : // Print Grbl NGC parameters
           if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
-          else { report_ngc_parameters(); }
+          #ifdef ENABLE_CHUNKED_REPORTS
+            else { report_chunked_start(REPORT_CHUNK_NGC_PARAMETERS,line); }
+          #else
+            else { report_ngc_parameters(); }
+          #endif
           break;
         case 'H' : // Perform homing cycle [IDLE/ALARM]
           if (bit_isfalse(settings.flags,BITFLAG_HOMING_ENABLE)) {return(STATUS_SETTING_DISABLED); }
@@ -198,6 +255,16 @@ uint8_t system_execute_line(char *line)
             if (line[2] == 0) { system_execute_startup(line); }
           }
           break;
+        #ifdef ENABLE_MOTION_TRACE
+          case 'T' : // Print executed-motion trace [IDLE/ALARM]
+            if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
+            #ifdef ENABLE_CHUNKED_REPORTS
+              else { report_chunked_start(REPORT_CHUNK_MOTION_TRACE,line); }
+            #else
+              else { report_motion_trace(); }
+            #endif
+            break;
+        #endif
         case 'S' : // Puts Grbl to sleep [IDLE/ALARM]
           if ((line[2] != 'L') || (line[3] != 'P') || (line[4] != 0)) { return(STATUS_INVALID_STATEMENT); }
           system_set_exec_state_flag(EXEC_SLEEP); // Set to execute sleep mode immediately
@@ -205,7 +272,13 @@ uint8_t system_execute_line(char *line)
         case 'I' : // Print or store build info. [IDLE/ALARM]
           if ( line[++char_counter] == 0 ) {
             settings_read_build_info(line);
-            report_build_info(line);
+            #ifdef ENABLE_CHUNKED_REPORTS
+              // NOTE: The line buffer holds the build info until the report completes, since the
+              // main loop doesn't read further commands into it while a chunked report is active.
+              report_chunked_start(REPORT_CHUNK_BUILD_INFO,line);
+            #else
+              report_build_info(line);
+            #endif
           #ifdef ENABLE_BUILD_INFO_WRITE_COMMAND
             } else { // Store startup line [IDLE/ALARM]
               if(line[char_counter++] != '=') { return(STATUS_INVALID_STATEMENT); }
@@ -0,0 +1,86 @@
+/*
+  avr.c - ATmega328p registers and EEPROM of the Grbl simulator and benchmark
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <avr/io.h>
+#include "sim.h"
+
+#define SIM_EEPROM_SIZE 1024
+
+
+// I/O registers. Input pins read high, as open switches with internal pull-ups.
+volatile uint8_t SREG, MCUSR, WDTCSR, SPMCSR;
+volatile uint8_t PINB = 0xff, DDRB, PORTB;
+volatile uint8_t PINC = 0xff, DDRC, PORTC;
+volatile uint8_t PIND = 0xff, DDRD, PORTD;
+volatile uint8_t PCICR, PCMSK0, PCMSK1, PCMSK2;
+volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A, OCR1B;
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UBRR0H, UBRR0L, UDR0;
+volatile uint16_t EEAR;
+
+
+// EEPROM contents, optionally backed by a file. A read strobe or a started write in the control
+// register is carried out on the next control or data register access.
+static uint8_t sim_eeprom[SIM_EEPROM_SIZE];
+static volatile uint8_t sim_eecr_value, sim_eedr_value;
+static int sim_eeprom_fd = -1;
+
+static void sim_eeprom_execute()
+{
+  uint16_t addr = EEAR % SIM_EEPROM_SIZE;
+  if (sim_eecr_value & (1<<EERE)) {
+    sim_eedr_value = sim_eeprom[addr];
+    sim_eecr_value &= ~(1<<EERE);
+  }
+  if (sim_eecr_value & (1<<EEPE)) {
+    switch (sim_eecr_value & ((1<<EEPM1)|(1<<EEPM0))) {
+      case (1<<EEPM0): sim_eeprom[addr] = 0xff; break; // Erase only
+      case (1<<EEPM1): sim_eeprom[addr] &= sim_eedr_value; break; // Write only
+      default: sim_eeprom[addr] = sim_eedr_value; // Erase and write
+    }
+    if (sim_eeprom_fd >= 0) {
+      if (pwrite(sim_eeprom_fd, &sim_eeprom[addr], 1, addr) != 1) { perror("grbl_sim: eeprom"); }
+    }
+    sim_eecr_value &= ~((1<<EEPE)|(1<<EEMPE));
+  }
+}
+
+volatile uint8_t *sim_eecr() { sim_eeprom_execute(); return(&sim_eecr_value); }
+volatile uint8_t *sim_eedr() { sim_eeprom_execute(); return(&sim_eedr_value); }
+
+void sim_eeprom_init(const char *path)
+{
+  memset(sim_eeprom, 0xff, SIM_EEPROM_SIZE); // Erased EEPROM
+  if (path == NULL) { return; }
+  sim_eeprom_fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (sim_eeprom_fd < 0) { perror(path); exit(EXIT_FAILURE); }
+  if (read(sim_eeprom_fd, sim_eeprom, SIM_EEPROM_SIZE) < 0) { perror(path); exit(EXIT_FAILURE); }
+}
+
+
+void sim_eeprom_sync() { sim_eeprom_execute(); }
@@ -0,0 +1,35 @@
+/*
+  interrupt.h - Interrupt shim for the Grbl simulator
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_avr_interrupt_h
+#define sim_avr_interrupt_h
+
+#include <avr/io.h>
+
+// The global interrupt flag is the I-bit of SREG. Interrupts requested while it is clear are held
+// off by the simulator until it is set again, including by restoring a saved SREG. Disabling
+// interrupts is a call, where the benchmark services its pending interrupts first.
+void sim_cli();
+#define sei() (SREG |= 0x80)
+#define cli() sim_cli()
+
+#define ISR(vector) void vector(void)
+
+#endif
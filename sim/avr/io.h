@@ -0,0 +1,143 @@
+/*
+  io.h - ATmega328p register shim for the Grbl simulator
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_avr_io_h
+#define sim_avr_io_h
+
+#include <stdint.h>
+
+#define __AVR_ATmega328P__
+
+// I/O registers are plain variables, defined in sim.c. The simulator reads the timer and UART
+// registers to schedule interrupts and writes the input pin registers and received bytes.
+#define SIM_REGISTER(name) extern volatile uint8_t name;
+#define SIM_REGISTER16(name) extern volatile uint16_t name;
+
+SIM_REGISTER(SREG)
+SIM_REGISTER(MCUSR)
+SIM_REGISTER(WDTCSR)
+SIM_REGISTER(SPMCSR)
+
+SIM_REGISTER(PINB) SIM_REGISTER(DDRB) SIM_REGISTER(PORTB)
+SIM_REGISTER(PINC) SIM_REGISTER(DDRC) SIM_REGISTER(PORTC)
+SIM_REGISTER(PIND) SIM_REGISTER(DDRD) SIM_REGISTER(PORTD)
+SIM_REGISTER(PCICR) SIM_REGISTER(PCMSK0) SIM_REGISTER(PCMSK1) SIM_REGISTER(PCMSK2)
+
+SIM_REGISTER(TCCR0A) SIM_REGISTER(TCCR0B) SIM_REGISTER(TCNT0) SIM_REGISTER(OCR0A) SIM_REGISTER(OCR0B)
+SIM_REGISTER(TIMSK0) SIM_REGISTER(TIFR0)
+SIM_REGISTER(TCCR1A) SIM_REGISTER(TCCR1B) SIM_REGISTER16(TCNT1) SIM_REGISTER16(OCR1A) SIM_REGISTER16(OCR1B)
+SIM_REGISTER(TIMSK1) SIM_REGISTER(TIFR1)
+SIM_REGISTER(TCCR2A) SIM_REGISTER(TCCR2B) SIM_REGISTER(TCNT2) SIM_REGISTER(OCR2A) SIM_REGISTER(OCR2B)
+SIM_REGISTER(TIMSK2) SIM_REGISTER(TIFR2)
+
+SIM_REGISTER(UCSR0A) SIM_REGISTER(UCSR0B) SIM_REGISTER(UCSR0C)
+SIM_REGISTER(UBRR0H) SIM_REGISTER(UBRR0L) SIM_REGISTER(UDR0)
+
+// The EEPROM control and data registers are accessor calls, which carry out a strobed read or a
+// started write operation on their next access, as the eeprom.c routines expect.
+SIM_REGISTER16(EEAR)
+volatile uint8_t *sim_eecr();
+volatile uint8_t *sim_eedr();
+#define EECR (*sim_eecr())
+#define EEDR (*sim_eedr())
+
+// Register bits used by Grbl.
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define WGM10 0
+#define WGM11 1
+#define WGM12 3
+#define WGM13 4
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define COM0A0 6
+#define COM0A1 7
+#define COM0B0 4
+#define COM0B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define COM1B0 4
+#define COM1B1 5
+#define COM2A0 6
+#define COM2A1 7
+#define COM2B0 4
+#define COM2B1 5
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOV0 0
+#define TOV1 0
+#define TOV2 0
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define U2X0 1
+#define UDRIE0 5
+#define TXEN0 3
+#define RXEN0 4
+#define RXCIE0 7
+#define EERE 0
+#define EEPE 1
+#define EEMPE 2
+#define EERIE 3
+#define EEPM0 4
+#define EEPM1 5
+#define SELFPRGEN 0
+#define WDRF 3
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE 3
+#define WDCE 4
+#define WDIE 6
+
+#define _BV(bit) (1 << (bit))
+
+// Interrupt vectors are plain functions, called by the simulator from its interrupt signal handler.
+#define TIMER1_COMPA_vect sim_vect_timer1_compa
+#define TIMER0_OVF_vect   sim_vect_timer0_ovf
+#define TIMER0_COMPA_vect sim_vect_timer0_compa
+#define TIMER2_OVF_vect   sim_vect_timer2_ovf
+#define TIMER2_COMPB_vect sim_vect_timer2_compb
+#define USART_RX_vect     sim_vect_usart_rx
+#define USART_UDRE_vect   sim_vect_usart_udre
+#define PCINT0_vect       sim_vect_pcint0
+#define PCINT1_vect       sim_vect_pcint1
+#define PCINT2_vect       sim_vect_pcint2
+#define WDT_vect          sim_vect_wdt
+
+#endif
@@ -0,0 +1,36 @@
+/*
+  pgmspace.h - Program memory shim for the Grbl simulator
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_avr_pgmspace_h
+#define sim_avr_pgmspace_h
+
+#include <stdint.h>
+
+// Program memory is ordinary read-only data on the host.
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_byte_near(address) pgm_read_byte(address)
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_word_near(address) pgm_read_word(address)
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_dword_near(address) pgm_read_dword(address)
+
+#endif
@@ -0,0 +1,783 @@
+/*
+  bench.c - Host benchmark of the Grbl g-code parser, planner and segment generator
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Runs g-code workloads through the same calls as the protocol main loop, gc_execute_line() or
+  system_execute_line() per line, with mc_line(), plan_buffer_line() and st_prep_buffer() below
+  them. The benchmark is single-threaded. The stepper and serial interrupts are serviced whenever
+  the main program disables interrupts, a few stepper timer ticks at a time. The stepper interrupt
+  runs only while the planner buffer is full, or while the main program waits for the motion to
+  complete in protocol_buffer_synchronize(), which is wrapped by the linker. This models a machine
+  that is slower than the main program, so the planner runs full as in a streamed job, and the
+  segment buffer drains while the main program keeps it filled.
+
+  The Grbl sources are built with the performance counters, which count the planned blocks,
+  prepared segments and planner recalculation steps. Times exclude the interrupts, so they measure
+  the main program. The machine time of the job is kept separately, as the sum of the executed
+  stepper timer periods and delays, as is the planner buffer coverage, the average motion time in
+  milliseconds queued in the full planner buffer while the job streams. The stepper interrupt is
+  timed on its own, as the mean host time per stepper timer tick, to compare the relative ISR cost
+  of options. One CSV line of results is printed per workload.
+
+  The status_reports workload also compares the original printFloat() of Grbl 1.1h, which generated
+  the digits with a 32-bit division and modulo each, with the current printFloat(). Both print the
+  position, work coordinate offset and feed rate values of each report, and their host times per
+  report are given.
+
+  With ENABLE_MOTION_TRACE, the motion trace record of every executed step segment can be written
+  to a CSV file, as the '$T' command would report them. The records are read from the trace ring
+  buffer after each stepper interrupt tick, so none are overwritten, and their timestamps are the
+  machine time in perf timer ticks.
+*/
+
+#define _GNU_SOURCE
+#include "../grbl/grbl.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim.h"
+
+#define BENCH_SERVICE_TICKS 8 // Stepper timer ticks executed per interrupt service.
+#define BENCH_CORPUS_BLOCK 65536
+
+// Workload corpus of formatted g-code lines, each terminated by a null character.
+typedef struct {
+  char *text;
+  size_t length, size;
+  uint32_t lines;
+} bench_corpus_t;
+
+static uint64_t bench_service_ns; // Time spent servicing interrupts during the current workload.
+static uint64_t bench_machine_cycles; // Executed stepper timer periods of the current workload.
+static uint64_t bench_stepper_ns; // Time spent in the stepper interrupt ticks of the current workload.
+static uint64_t bench_stepper_ticks; // Executed stepper interrupt ticks of the current workload.
+static uint64_t bench_report_ns; // Time spent formatting status reports during the current workload.
+static uint32_t bench_reports; // Status reports of the current workload.
+static uint64_t bench_values_ns[2]; // Time spent printing the report values, original and current.
+static uint16_t bench_status_lines; // Lines between status reports of the g-code file workloads.
+static bool bench_stepper_interrupt; // Set while the stepper interrupt runs.
+#ifdef ENABLE_MOTION_TRACE
+  static FILE *bench_trace; // Motion trace output file. NULL, if not written.
+  static const char *bench_trace_workload; // Workload of the written trace records.
+  static uint32_t bench_trace_records; // Motion trace records recorded by the stepper interrupt.
+#endif
+static double bench_delay_us; // Delays of the current workload.
+static bool bench_draining; // Runs the stepper interrupt regardless of the planner buffer.
+static double bench_buffer_time; // Planner buffer time, summed over the stepper periods it was held for.
+static uint64_t bench_buffer_cycles; // Stepper periods executed while streaming.
+
+void __real_protocol_buffer_synchronize();
+uint32_t __real_perf_get_ticks();
+
+
+static uint64_t bench_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return((uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec);
+}
+
+
+static void bench_interrupt(void (*vector)(void))
+{
+  if (vector == NULL) { return; }
+  SREG &= ~0x80;
+  vector();
+  SREG |= 0x80;
+}
+
+#ifdef ENABLE_MOTION_TRACE
+  // Writes the motion trace record of a segment completed by the last stepper interrupt tick.
+  static void bench_trace_write()
+  {
+    static uint32_t written;
+    if ((bench_trace == NULL) || (written == bench_trace_records)) { return; }
+    written = bench_trace_records;
+    st_trace_t record;
+    SREG &= ~0x80; // Read the record as the main program would, without servicing interrupts.
+    st_get_trace_record(min(written,MOTION_TRACE_SIZE)-1, &record); // Newest record
+    SREG |= 0x80;
+    fprintf(bench_trace, "%s,%u,%u,%u,%u,%u", bench_trace_workload, record.timestamp, record.st_block_index,
+            record.n_step, record.cycles_per_tick,
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+            record.amass_level);
+    #else
+            record.prescaler);
+    #endif
+    #ifdef USE_LINE_NUMBERS
+      fprintf(bench_trace, ",%d", record.line_number);
+    #endif
+    fprintf(bench_trace, "\n");
+  }
+#endif
+
+// Empties the serial TX buffer. Messages are discarded.
+static void bench_serial_send()
+{
+  while (UCSR0B & (1<<UDRIE0)) { bench_interrupt(USART_UDRE_vect); }
+}
+
+// Executes pending interrupts, while interrupts are enabled, before the main program disables them.
+void sim_cli()
+{
+  if (SREG & 0x80) {
+    uint64_t start = bench_ns();
+    if (bench_draining || plan_check_full_buffer()) {
+      uint64_t cycles = bench_machine_cycles;
+      uint64_t stepper_start = bench_ns();
+      uint8_t tick;
+      for (tick = 0; (tick < BENCH_SERVICE_TICKS) && (TIMSK1 & (1<<OCIE1A)); tick++) {
+        static const uint16_t prescaler[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+        bench_machine_cycles += ((uint32_t)OCR1A+1)*prescaler[TCCR1B & 0x07];
+        bench_stepper_interrupt = true;
+        bench_interrupt(TIMER1_COMPA_vect);
+        bench_stepper_interrupt = false;
+        if (TCCR0B & 0x07) { bench_interrupt(TIMER0_OVF_vect); } // End the step pulse.
+        #ifdef ENABLE_MOTION_TRACE
+          bench_trace_write();
+        #endif
+      }
+      bench_stepper_ns += bench_ns()-stepper_start;
+      bench_stepper_ticks += tick;
+      if (!bench_draining) {
+        // Average the motion time covered by the full planner buffer over the streamed job.
+        bench_buffer_time += (double)plan_get_block_buffer_time()*(bench_machine_cycles-cycles);
+        bench_buffer_cycles += bench_machine_cycles-cycles;
+      }
+    }
+    bench_serial_send();
+    bench_service_ns += bench_ns()-start;
+  }
+  SREG &= ~0x80;
+}
+
+// Lets the motion run to completion while the main program waits for it.
+void __wrap_protocol_buffer_synchronize()
+{
+  bool draining = bench_draining;
+  bench_draining = true;
+  __real_protocol_buffer_synchronize();
+  bench_draining = draining;
+}
+
+// The spindle timer of the perf timer time base is not run. Motion trace records of the stepper
+// interrupt are timestamped in machine time instead, in perf timer ticks, and counted.
+uint32_t __wrap_perf_get_ticks()
+{
+  if (bench_stepper_interrupt) {
+    #ifdef ENABLE_MOTION_TRACE
+      bench_trace_records++;
+    #endif
+    return(bench_machine_cycles/SPINDLE_TIMER_PRESCALER);
+  }
+  return(__real_perf_get_ticks());
+}
+
+// Delays are skipped, but counted in the machine time.
+void sim_delay_us(double us) { bench_delay_us += us; }
+
+
+static void bench_corpus_add(bench_corpus_t *corpus, const char *format, ...)
+{
+  char line[LINE_BUFFER_SIZE];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (corpus->length+length+1 > corpus->size) {
+    corpus->size += BENCH_CORPUS_BLOCK;
+    corpus->text = realloc(corpus->text, corpus->size);
+    if (corpus->text == NULL) { perror("grbl_bench"); exit(EXIT_FAILURE); }
+  }
+  memcpy(corpus->text+corpus->length, line, length+1);
+  corpus->length += length+1;
+  corpus->lines++;
+}
+
+
+// 3D finishing pass. Zig-zag rows of 0.05mm micro-segments over a curved surface.
+static void bench_workload_finishing(bench_corpus_t *corpus)
+{
+  uint16_t row, col;
+  bench_corpus_add(corpus, "G21G90G94G17F2000");
+  for (row = 0; row < 40; row++) {
+    for (col = 0; col <= 400; col++) {
+      float x = ((row & 1) ? 400-col : col)*0.05;
+      float y = row*0.5;
+      float z = -1.0+0.5*sin(x*0.3)*cos(y*0.2);
+      bench_corpus_add(corpus, "G1X%.3fY%.3fZ%.3f", x, y, z);
+    }
+  }
+}
+
+// Dense arcs. Chains of small alternating half circles, which the arc generator breaks into
+// short line segments.
+static void bench_workload_arcs(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  bench_corpus_add(corpus, "G21G90G94G17F1500G0X0Y0");
+  for (idx = 0; idx < 1000; idx++) {
+    float x = (idx+1)*2.0;
+    if (idx & 1) { bench_corpus_add(corpus, "G3X%.3fY0I1.000J0", x); }
+    else { bench_corpus_add(corpus, "G2X%.3fY0I1.000J0", x); }
+  }
+}
+
+// Slow arcs. Larger half circles at a feed rate below the speed their segment junctions allow, as in
+// finishing passes with a small step-over.
+static void bench_workload_arcs_slow(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  bench_corpus_add(corpus, "G21G90G94G17F300G0X0Y0");
+  for (idx = 0; idx < 200; idx++) {
+    float x = (idx+1)*10.0;
+    if (idx & 1) { bench_corpus_add(corpus, "G3X%.3fY0I5.000J0", x); }
+    else { bench_corpus_add(corpus, "G2X%.3fY0I5.000J0", x); }
+  }
+}
+
+// Laser raster. Laser mode rows of 0.1mm pixels, each a G1 move with a new power.
+static void bench_workload_raster(bench_corpus_t *corpus)
+{
+  uint16_t row, col;
+  bench_corpus_add(corpus, "$32=1");
+  bench_corpus_add(corpus, "G21G90G94G17F3000M4S0");
+  for (row = 0; row < 20; row++) {
+    bench_corpus_add(corpus, "G0X0Y%.3f", row*0.1);
+    for (col = 1; col <= 300; col++) {
+      bench_corpus_add(corpus, "G1X%.3fS%u", col*0.1, (col*37+row*11) % 1000);
+    }
+  }
+  bench_corpus_add(corpus, "M5");
+  bench_corpus_add(corpus, "$32=0");
+}
+
+// Long rapids between opposite corners of the work area.
+static void bench_workload_rapids(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  bench_corpus_add(corpus, "G21G90");
+  for (idx = 0; idx < 100; idx++) {
+    if (idx & 1) { bench_corpus_add(corpus, "G0X0Y0Z0"); }
+    else { bench_corpus_add(corpus, "G0X150.000Y120.000Z-40.000"); }
+  }
+}
+
+// Jog sequence. Short incremental jogs, as streamed by a pendant or a held key.
+static void bench_workload_jog(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  for (idx = 0; idx < 2000; idx++) {
+    switch (idx & 3) {
+      case 0: bench_corpus_add(corpus, "$J=G91G21X0.500F1000"); break;
+      case 1: bench_corpus_add(corpus, "$J=G91G21Y0.500F1000"); break;
+      case 2: bench_corpus_add(corpus, "$J=G91G21X-0.500Y0.250F1000"); break;
+      default: bench_corpus_add(corpus, "$J=G91G21Y-0.250Z0.010F1000");
+    }
+  }
+}
+
+
+// Status reports. A job polled for a realtime status report after every line, as by a streaming
+// host. The spiral moves around a work offset, so the reported positions vary in sign and digits.
+static void bench_workload_status_reports(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  bench_corpus_add(corpus, "G21G90G94G17F3000");
+  bench_corpus_add(corpus, "G92X12.345Y-6.789Z1.500");
+  for (idx = 0; idx < 2000; idx++) {
+    float radius = 1.0+idx*0.02;
+    bench_corpus_add(corpus, "G1X%.3fY%.3fZ%.3f", radius*cos(idx*0.1), radius*sin(idx*0.1), -0.001*idx);
+  }
+  bench_corpus_add(corpus, "G92.1");
+}
+
+// Drilling. A plate of 20x25 holes on a 5mm grid, peck drilled 3mm deep in 1mm pecks with a
+// return to the R plane. As canned G83 cycles, one line per hole, or as the same motions expanded
+// into G0/G1 lines by the host, nine lines per hole.
+#define BENCH_DRILL_ROWS 20
+#define BENCH_DRILL_COLS 25
+
+static void bench_drill_hole(uint16_t idx, float *x, float *y)
+{
+  uint16_t row = idx/BENCH_DRILL_COLS;
+  uint16_t col = idx%BENCH_DRILL_COLS;
+  if (row & 1) { col = BENCH_DRILL_COLS-1-col; }
+  *x = col*5.0;
+  *y = row*5.0;
+}
+
+#ifdef ENABLE_CANNED_CYCLES
+static void bench_workload_drilling(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  float x, y;
+  bench_corpus_add(corpus, "G21G90G94G17G0Z5");
+  for (idx = 0; idx < BENCH_DRILL_ROWS*BENCH_DRILL_COLS; idx++) {
+    bench_drill_hole(idx, &x, &y);
+    if (idx == 0) { bench_corpus_add(corpus, "G99G83X%.3fY%.3fZ-3.000R0.000Q1.000F300", x, y); }
+    else { bench_corpus_add(corpus, "X%.3fY%.3f", x, y); }
+  }
+  bench_corpus_add(corpus, "G80");
+  bench_corpus_add(corpus, "G0Z5");
+}
+
+// Deep drilling. One row of 25 holes at each of G81, G83 and G73, 8.06mm from the R plane to the
+// bottom, which is no multiple of the peck depth. The G73 peck depth divides it exactly in decimal,
+// but not in float. Checked by its planned block count, so that no cycle adds a sliver of a feed
+// past the last full depth, nor a last short peck left by rounding.
+static void bench_workload_drilling_deep(bench_corpus_t *corpus)
+{
+  static const char *cycles[] = { "G81", "G83Q2.000", "G73Q2.015" };
+  uint8_t cycle;
+  uint16_t col;
+  bench_corpus_add(corpus, "G21G90G94G17G0Z5");
+  for (cycle = 0; cycle < 3; cycle++) {
+    for (col = 0; col < BENCH_DRILL_COLS; col++) {
+      if (col == 0) { bench_corpus_add(corpus, "G99%sX0.000Y%.3fZ-15.960R-7.900F300", cycles[cycle], cycle*5.0); }
+      else { bench_corpus_add(corpus, "X%.3f", col*5.0); }
+    }
+    bench_corpus_add(corpus, "G80");
+  }
+  bench_corpus_add(corpus, "G0Z5");
+}
+#endif
+
+static void bench_workload_drilling_expanded(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  uint8_t peck;
+  float x, y;
+  bench_corpus_add(corpus, "G21G90G94G17G0Z5");
+  for (idx = 0; idx < BENCH_DRILL_ROWS*BENCH_DRILL_COLS; idx++) {
+    bench_drill_hole(idx, &x, &y);
+    bench_corpus_add(corpus, "G0X%.3fY%.3f", x, y);
+    if (idx == 0) { bench_corpus_add(corpus, "Z0.000"); }
+    for (peck = 1; peck <= 3; peck++) {
+      if (peck > 1) { bench_corpus_add(corpus, "G0Z%.3f", 1.254-peck); }
+      bench_corpus_add(corpus, "G1Z%.3fF300", -1.0*peck);
+      bench_corpus_add(corpus, "G0Z0.000");
+    }
+  }
+  bench_corpus_add(corpus, "G0Z5");
+}
+
+
+// Facing. 40 passes of a 50x20mm zigzag, each 0.5mm deeper than the last, in incremental moves. As a
+// subprogram repeat, stored and replayed by Grbl, or with every pass streamed.
+#define BENCH_FACING_PASSES 40
+
+static void bench_facing_pass(bench_corpus_t *corpus)
+{
+  bench_corpus_add(corpus, "G1Z-0.5");
+  bench_corpus_add(corpus, "X50");
+  bench_corpus_add(corpus, "Y5");
+  bench_corpus_add(corpus, "X-50");
+  bench_corpus_add(corpus, "Y5");
+  bench_corpus_add(corpus, "X50");
+  bench_corpus_add(corpus, "Y5");
+  bench_corpus_add(corpus, "X-50");
+  bench_corpus_add(corpus, "G0Y-15");
+}
+
+#ifdef ENABLE_SUBPROGRAMS
+static void bench_workload_facing(bench_corpus_t *corpus)
+{
+  bench_corpus_add(corpus, "G21G91G94G17F1000");
+  bench_corpus_add(corpus, "O100REPEAT[%u]", BENCH_FACING_PASSES);
+  bench_facing_pass(corpus);
+  bench_corpus_add(corpus, "O100ENDREPEAT");
+  bench_corpus_add(corpus, "G0Z20");
+}
+#endif
+
+static void bench_workload_facing_expanded(bench_corpus_t *corpus)
+{
+  uint8_t pass;
+  bench_corpus_add(corpus, "G21G91G94G17F1000");
+  for (pass = 0; pass < BENCH_FACING_PASSES; pass++) { bench_facing_pass(corpus); }
+  bench_corpus_add(corpus, "G0Z20");
+}
+
+
+// Freeform contour. A wave of 5mm amplitude and 20mm period along 500mm, as a profile pass. As G5
+// splines, one per quarter wave with each continuing the last, or as the 0.1mm G1 segments of the
+// same wave output by a CAM system.
+#define BENCH_CONTOUR_LENGTH 500
+#define BENCH_CONTOUR_AMPLITUDE 5.0
+#define BENCH_CONTOUR_PERIOD 20.0
+
+#ifdef ENABLE_SPLINES
+static void bench_workload_contour(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  float h = 0.25*BENCH_CONTOUR_PERIOD;
+  float slope = BENCH_CONTOUR_AMPLITUDE*2.0*M_PI/BENCH_CONTOUR_PERIOD; // Slope at the zero crossings
+  bench_corpus_add(corpus, "G21G90G94G17F1500G0X0Y0");
+  for (idx = 1; idx <= 4*BENCH_CONTOUR_LENGTH/BENCH_CONTOUR_PERIOD; idx++) {
+    // Cubic Hermite quarter waves, between the zero crossings and the peaks.
+    float y = (idx & 1) ? ((idx & 2) ? -BENCH_CONTOUR_AMPLITUDE : BENCH_CONTOUR_AMPLITUDE) : 0.0;
+    float q = (idx & 1) ? 0.0 : ((idx & 2) ? slope*h/3.0 : -slope*h/3.0);
+    if (idx == 1) { bench_corpus_add(corpus, "G5X%.3fY%.3fI%.3fJ%.3fP%.3fQ%.3f", h, y, h/3.0, slope*h/3.0, -h/3.0, q); }
+    else { bench_corpus_add(corpus, "X%.3fY%.3fP%.3fQ%.3f", idx*h, y, -h/3.0, q); }
+  }
+}
+#endif
+
+static void bench_workload_contour_expanded(bench_corpus_t *corpus)
+{
+  uint16_t idx;
+  bench_corpus_add(corpus, "G21G90G94G17F1500G0X0Y0");
+  for (idx = 1; idx <= 10*BENCH_CONTOUR_LENGTH; idx++) {
+    float x = idx*0.1;
+    bench_corpus_add(corpus, "G1X%.3fY%.3f", x, BENCH_CONTOUR_AMPLITUDE*sin(2.0*M_PI*x/BENCH_CONTOUR_PERIOD));
+  }
+}
+
+
+// Reads a g-code file into a corpus, formatted like the protocol main loop does. Whitespace and
+// comments are removed, letters capitalized, and empty lines and program '%' lines dropped.
+static void bench_corpus_read(bench_corpus_t *corpus, const char *path)
+{
+  FILE *file = fopen(path, "r");
+  if (file == NULL) { perror(path); exit(EXIT_FAILURE); }
+  char text[256];
+  while (fgets(text, sizeof(text), file)) {
+    char line[LINE_BUFFER_SIZE];
+    uint8_t length = 0;
+    char *c;
+    for (c = text; *c && (*c != ';'); c++) {
+      if (*c == '(') {
+        while (*c && (*c != ')')) { c++; }
+        if (!*c) { break; }
+      } else if ((*c > ' ') && (*c != '%') && (length < LINE_BUFFER_SIZE-1)) {
+        line[length++] = ((*c >= 'a') && (*c <= 'z')) ? *c-'a'+'A' : *c;
+      }
+    }
+    line[length] = 0;
+    if (length) { bench_corpus_add(corpus, "%s", line); }
+  }
+  fclose(file);
+}
+
+
+// Clears the Grbl state to that after a reset, as in main(), with the machine at its origin.
+static void bench_reset()
+{
+  memset(&sys, 0, sizeof(system_t));
+  sys.state = STATE_IDLE;
+  sys.f_override = DEFAULT_FEED_OVERRIDE;
+  sys.r_override = DEFAULT_RAPID_OVERRIDE;
+  sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE;
+  memset(sys_position, 0, sizeof(sys_position));
+  sys_rt_exec_state = 0;
+  sys_rt_exec_alarm = 0;
+  sys_rt_exec_motion_override = 0;
+  sys_rt_exec_accessory_override = 0;
+
+  serial_reset_read_buffer();
+  gc_init();
+  spindle_init();
+  #ifdef ENABLE_AUTO_STATUS_REPORT
+    report_auto_init();
+  #endif
+  coolant_init();
+  limits_init();
+  probe_init();
+  plan_reset();
+  st_reset();
+  #ifdef ENABLE_LAZY_ARCS
+    mc_arc_reset();
+  #endif
+  #ifdef ENABLE_LASER_RASTER
+    raster_reset();
+  #endif
+  #ifdef ENABLE_CHUNKED_REPORTS
+    report_chunked_reset();
+  #endif
+  #ifdef ENABLE_SUBPROGRAMS
+    subprogram_reset();
+  #endif
+  plan_sync_position();
+  gc_sync_position();
+  perf_reset();
+}
+
+
+// printFloat() of Grbl 1.1h, before its digits were generated by print_uint32_fixed(). Kept for the
+// status_reports comparison.
+static void bench_print_float_original(float n, uint8_t decimal_places)
+{
+  if (n < 0) {
+    serial_write('-');
+    n = -n;
+  }
+
+  uint8_t decimals = decimal_places;
+  while (decimals >= 2) { // Quickly convert values expected to be E0 to E-4.
+    n *= 100;
+    decimals -= 2;
+  }
+  if (decimals) { n *= 10; }
+  n += 0.5; // Add rounding factor. Ensures carryover through entire value.
+
+  // Generate digits backwards and store in string.
+  unsigned char buf[13];
+  uint8_t i = 0;
+  uint32_t a = (long)n;
+  while(a > 0) {
+    buf[i++] = (a % 10) + '0'; // Get digit
+    a /= 10;
+  }
+  while (i < decimal_places) {
+     buf[i++] = '0'; // Fill in zeros to decimal point for (n < 1)
+  }
+  if (i == decimal_places) { // Fill in leading zero, if needed.
+    buf[i++] = '0';
+  }
+
+  // Print the generated string.
+  for (; i > 0; i--) {
+    if (i == decimal_places) { serial_write('.'); } // Insert decimal point in right place.
+    serial_write(buf[i-1]);
+  }
+}
+
+
+// Prints the machine position, work coordinate offset and feed rate values of a status report with
+// the given printFloat(), and returns the time in ns. The characters are sent after the timing.
+static uint64_t bench_report_values(void (*print_float)(float, uint8_t))
+{
+  float value[2*N_AXIS+1];
+  uint8_t idx;
+  system_convert_array_steps_to_mpos(value, sys_position);
+  for (idx = 0; idx < N_AXIS; idx++) { value[N_AXIS+idx] = gc_state.coord_system[idx]+gc_state.coord_offset[idx]; }
+  value[2*N_AXIS] = st_get_realtime_rate();
+  uint64_t start = bench_ns();
+  for (idx = 0; idx < 2*N_AXIS; idx++) { print_float(value[idx], N_DECIMAL_COORDVALUE_MM); }
+  print_float(value[2*N_AXIS], N_DECIMAL_RATEVALUE_MM);
+  uint64_t ns = bench_ns()-start;
+  bench_serial_send();
+  return(ns);
+}
+
+
+// Runs a workload and prints its results. Returns false, if a line failed or the planned blocks
+// differ from expected_blocks, unless zero. Requests a status report after every status_lines lines,
+// unless zero.
+static bool bench_run(FILE *results, const char *name, bench_corpus_t *corpus, uint16_t status_lines,
+                      uint32_t expected_blocks)
+{
+  bool success = true;
+  char line[LINE_BUFFER_SIZE];
+  char *text = corpus->text;
+  uint32_t idx;
+
+  bench_reset();
+  #ifdef ENABLE_MOTION_TRACE
+    bench_trace_workload = name;
+  #endif
+  bench_service_ns = 0;
+  bench_machine_cycles = 0;
+  bench_stepper_ns = 0;
+  bench_stepper_ticks = 0;
+  bench_report_ns = 0;
+  bench_reports = 0;
+  bench_values_ns[0] = bench_values_ns[1] = 0;
+  bench_delay_us = 0.0;
+  bench_buffer_time = 0.0;
+  bench_buffer_cycles = 0;
+  uint64_t compare_ns = 0; // Time of the printFloat() comparison, which is not part of the main program.
+  uint64_t start = bench_ns();
+  for (idx = 0; idx < corpus->lines; idx++) {
+    strcpy(line, text); // Executing a line may modify it.
+    text += strlen(text)+1;
+    uint8_t status_code;
+    if (line[0] == '$') { status_code = system_execute_line(line); }
+    #ifdef ENABLE_SUBPROGRAMS
+      else if ((line[0] == 'O') || subprogram_is_recording()) { status_code = subprogram_execute_line(line); }
+    #endif
+    else { status_code = gc_execute_line(line); }
+    if (status_code != STATUS_OK) {
+      fprintf(stderr, "grbl_bench: %s line %u: error:%u\n", name, idx+1, status_code);
+      success = false;
+      break;
+    }
+    #ifdef ENABLE_LAZY_ARCS
+      mc_arc_continue();
+    #endif
+    protocol_auto_cycle_start();
+    protocol_execute_realtime();
+    if (status_lines && ((idx+1) % status_lines == 0)) {
+      uint64_t report_start = bench_ns();
+      report_realtime_status();
+      bench_report_ns += bench_ns()-report_start;
+      bench_reports++;
+      cli(); sei(); // Service the interrupts, which send the report. Each must fit the TX buffer.
+      report_start = bench_ns();
+      bench_values_ns[0] += bench_report_values(bench_print_float_original);
+      bench_values_ns[1] += bench_report_values(printFloat);
+      compare_ns += bench_ns()-report_start;
+    }
+  }
+  protocol_buffer_synchronize(); // Complete the motion.
+  uint64_t main_ns = bench_ns()-start-bench_service_ns-compare_ns;
+  if (sys.state == STATE_ALARM) {
+    fprintf(stderr, "grbl_bench: %s alarm:%u\n", name, sys_rt_exec_alarm);
+    success = false;
+  }
+
+  double seconds = main_ns/1e9;
+  uint32_t blocks = perf_timer[PERF_TIMER_PLAN_BUFFER].count;
+  uint32_t segments = perf_count[PERF_COUNT_SEGMENT];
+  fprintf(results, "%s,%u,%u,%u,%.3f,%u,%.6f,%.0f,%.0f,%.3f,%.1f,%.1f,%u,%.0f,%.1f,%.1f\n", name, corpus->lines, blocks, segments,
+          (blocks ? (double)perf_count[PERF_COUNT_RECALC_BLOCK]/blocks : 0.0),
+          perf_event[PERF_EVENT_SEGMENT_UNDERRUN], seconds, blocks/seconds, segments/seconds,
+          (double)bench_machine_cycles/F_CPU + bench_delay_us/1e6,
+          (bench_buffer_cycles ? 60000.0*bench_buffer_time/bench_buffer_cycles : 0.0),
+          (bench_stepper_ticks ? (double)bench_stepper_ns/bench_stepper_ticks : 0.0),
+          bench_reports, (bench_report_ns ? bench_reports/(bench_report_ns/1e9) : 0.0),
+          (bench_reports ? (double)bench_values_ns[0]/bench_reports : 0.0),
+          (bench_reports ? (double)bench_values_ns[1]/bench_reports : 0.0));
+  fflush(results);
+  if (expected_blocks && (blocks != expected_blocks)) {
+    fprintf(stderr, "grbl_bench: %s planned %u blocks, expected %u\n", name, blocks, expected_blocks);
+    success = false;
+  }
+  return(success);
+}
+
+
+static void bench_usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [options] [file.nc ...]\n"
+    "  Runs the built-in workloads, or the given g-code files, and prints CSV results.\n"
+    "  -o file   Write the results to this file instead of stdout\n"
+    "  -r count  Run each workload this many times (default: 1)\n"
+    "  -s lines  Request a status report every this many lines of the files (default: 0, none)\n"
+    "  -t file   Write the motion trace records of all segments to this file, with ENABLE_MOTION_TRACE\n", name);
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+  static const struct {
+    const char *name;
+    void (*generate)(bench_corpus_t *corpus);
+    uint16_t status_lines; // Lines between status reports. Zero for none.
+    uint32_t blocks; // Expected planned blocks. Zero, if not checked.
+  } workloads[] = {
+    { "finishing", bench_workload_finishing },
+    { "arcs", bench_workload_arcs },
+    { "arcs_slow", bench_workload_arcs_slow },
+    { "raster", bench_workload_raster },
+    { "rapids", bench_workload_rapids },
+    { "jog", bench_workload_jog },
+    { "status_reports", bench_workload_status_reports, 1 },
+    #ifdef ENABLE_CANNED_CYCLES
+      { "drilling", bench_workload_drilling },
+      { "drilling_deep", bench_workload_drilling_deep, 0, 752 },
+    #endif
+    { "drilling_expanded", bench_workload_drilling_expanded },
+    #ifdef ENABLE_SUBPROGRAMS
+      { "facing", bench_workload_facing },
+    #endif
+    { "facing_expanded", bench_workload_facing_expanded },
+    #ifdef ENABLE_SPLINES
+      { "contour", bench_workload_contour },
+    #endif
+    { "contour_expanded", bench_workload_contour_expanded },
+  };
+
+  FILE *results = stdout;
+  uint16_t repeat = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "o:r:s:t:")) != -1) {
+    switch (opt) {
+      case 'o':
+        results = fopen(optarg, "w");
+        if (results == NULL) { perror(optarg); return(EXIT_FAILURE); }
+        break;
+      case 'r': repeat = strtoul(optarg, NULL, 10); if (repeat == 0) { bench_usage(argv[0]); } break;
+      case 's': bench_status_lines = strtoul(optarg, NULL, 10); break;
+      #ifdef ENABLE_MOTION_TRACE
+        case 't':
+          bench_trace = fopen(optarg, "w");
+          if (bench_trace == NULL) { perror(optarg); return(EXIT_FAILURE); }
+          break;
+      #endif
+      default: bench_usage(argv[0]);
+    }
+  }
+
+  // Power-up, as in main(), with default settings in the EEPROM.
+  sim_eeprom_init(NULL);
+  serial_init();
+  settings_restore(SETTINGS_RESTORE_ALL);
+  settings_init();
+  stepper_init();
+  system_init();
+  perf_init();
+  sei();
+
+  fprintf(results, "workload,lines,blocks,segments,recalc_per_block,underruns,seconds,blocks_per_sec,segments_per_sec,machine_seconds,buffer_ms,stepper_tick_ns,reports,reports_per_sec,report_values_ns_original,report_values_ns\n");
+  #ifdef ENABLE_MOTION_TRACE
+    if (bench_trace != NULL) {
+      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        fprintf(bench_trace, "workload,timestamp,st_block_index,n_step,cycles_per_tick,amass_level");
+      #else
+        fprintf(bench_trace, "workload,timestamp,st_block_index,n_step,cycles_per_tick,prescaler");
+      #endif
+      #ifdef USE_LINE_NUMBERS
+        fprintf(bench_trace, ",line_number");
+      #endif
+      fprintf(bench_trace, "\n");
+    }
+  #endif
+  bool success = true;
+  uint16_t run;
+  if (optind < argc) {
+    int idx;
+    for (idx = optind; idx < argc; idx++) {
+      bench_corpus_t corpus = { NULL, 0, 0, 0 };
+      bench_corpus_read(&corpus, argv[idx]);
+      for (run = 0; run < repeat; run++) { success &= bench_run(results, argv[idx], &corpus, bench_status_lines, 0); }
+      free(corpus.text);
+    }
+  } else {
+    uint8_t idx;
+    for (idx = 0; idx < sizeof(workloads)/sizeof(workloads[0]); idx++) {
+      bench_corpus_t corpus = { NULL, 0, 0, 0 };
+      workloads[idx].generate(&corpus);
+      for (run = 0; run < repeat; run++) {
+        success &= bench_run(results, workloads[idx].name, &corpus, workloads[idx].status_lines,
+                             workloads[idx].blocks);
+      }
+      free(corpus.text);
+    }
+  }
+  #ifdef ENABLE_MOTION_TRACE
+    if (bench_trace != NULL) { fclose(bench_trace); }
+  #endif
+  return(success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,197 @@
+/*
+  estimate.c - Host execution time estimate of g-code files
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Runs a g-code file through the '$C' check mode estimator of ENABLE_CHECK_MODE_ESTIMATE, as if it
+  was streamed to the controller, and prints the estimated motion time of each line and the total
+  time of the file. The Grbl sources are built with the estimator and line numbers enabled. The
+  Grbl main() powers up as usual, with the settings of the given EEPROM file, or the defaults, and
+  the protocol main loop is replaced by the linker with the file reader below.
+
+  Each g-code line is numbered by its line in the file, in place of any N word, so that the [EST:N]
+  line reports of the estimator map to the file lines. System commands, such as '$L' raster lines,
+  take the line number of their file line as well. Dwells are only included in the total time.
+  Messages and reports of the controller are discarded, and status errors are printed instead.
+*/
+
+#include "../grbl/grbl.h"
+#include <stdio.h>
+#include <unistd.h>
+#include "sim.h"
+
+#define ESTIMATE_TEXT_SIZE 256 // Longest file line read.
+
+static float *estimate_line_seconds; // Estimated motion time of each file line.
+static uint32_t estimate_lines;
+static float estimate_total_seconds;
+static FILE *estimate_file;
+static const char *estimate_path;
+
+int grbl_main(void);
+
+
+// No interrupts are serviced. The stepper interrupt does not run in check mode, and the serial
+// output is discarded as it is written.
+void sim_cli() { SREG &= ~0x80; }
+void __wrap_serial_write(uint8_t data) { }
+
+// Delays are skipped. Check mode dwells are added to the estimate by the estimator itself.
+void sim_delay_us(double us) { }
+
+
+// Collects the estimator reports, instead of printing them.
+void __wrap_report_estimate_line(int32_t line_number, float seconds)
+{
+  if ((line_number > 0) && (line_number <= estimate_lines)) { estimate_line_seconds[line_number-1] += seconds; }
+}
+
+// Each program end (M2/M30) reports the time of its program, and restarts the estimate.
+void __wrap_report_estimate_total(float seconds) { estimate_total_seconds += seconds; }
+
+
+// Removes the N words of a g-code line and numbers it with the given file line number instead.
+// Returns false, if the line is too long.
+static bool estimate_number_line(char *line, uint32_t line_number)
+{
+  char text[LINE_BUFFER_SIZE];
+  uint8_t length = 0;
+  char *c = line;
+  while (*c) {
+    if (*c == 'N') {
+      c++;
+      while (((*c >= '0') && (*c <= '9')) || (*c == '.')) { c++; }
+    } else {
+      text[length++] = *c++;
+    }
+  }
+  text[length] = 0;
+  return(snprintf(line, LINE_BUFFER_SIZE, "N%u%s", line_number, text) < LINE_BUFFER_SIZE);
+}
+
+
+// Executes one line, as the protocol main loop would, and returns its status.
+static uint8_t estimate_execute_line(char *line, uint32_t line_number)
+{
+  if (line[0] == '$') {
+    gc_state.line_number = line_number;
+    return(system_execute_line(line));
+  }
+  #ifdef ENABLE_SUBPROGRAMS
+    if (line[0] == 'O') { return(subprogram_execute_line(line)); }
+  #endif
+  if (!estimate_number_line(line, line_number)) { return(STATUS_OVERFLOW); }
+  #ifdef ENABLE_SUBPROGRAMS
+    if (subprogram_is_recording()) { return(subprogram_execute_line(line)); }
+  #endif
+  return(gc_execute_line(line));
+}
+
+
+// Replaces the protocol main loop after power-up. Estimates the file and exits.
+void __wrap_protocol_main_loop()
+{
+  char text[ESTIMATE_TEXT_SIZE];
+  char line[LINE_BUFFER_SIZE];
+  char check_mode[] = "$C";
+  uint32_t errors = 0;
+
+  if (system_execute_line(check_mode) != STATUS_OK) {
+    fprintf(stderr, "grbl_estimate: check mode unavailable in state %u\n", sys.state);
+    exit(EXIT_FAILURE);
+  }
+
+  // Read the file, with comments, spaces and block delete characters removed, as by the protocol.
+  while (fgets(text, sizeof(text), estimate_file)) {
+    estimate_lines++;
+    estimate_line_seconds = realloc(estimate_line_seconds, estimate_lines*sizeof(float));
+    if (estimate_line_seconds == NULL) { perror("grbl_estimate"); exit(EXIT_FAILURE); }
+    estimate_line_seconds[estimate_lines-1] = 0.0;
+
+    uint8_t length = 0;
+    char *c;
+    for (c = text; *c && (*c != ';'); c++) {
+      if (*c == '(') {
+        while (*c && (*c != ')')) { c++; }
+        if (!*c) { break; }
+      } else if ((*c > ' ') && (*c != '%') && (length < LINE_BUFFER_SIZE-1)) {
+        line[length++] = ((*c >= 'a') && (*c <= 'z')) ? *c-'a'+'A' : *c;
+      }
+    }
+    line[length] = 0;
+    if (length == 0) { continue; }
+
+    uint8_t status_code = estimate_execute_line(line, estimate_lines);
+    if (status_code != STATUS_OK) {
+      fprintf(stderr, "grbl_estimate: %s line %u: error:%u\n", estimate_path, estimate_lines, status_code);
+      errors++;
+    }
+    #ifdef ENABLE_LAZY_ARCS
+      mc_arc_continue();
+    #endif
+    protocol_execute_realtime();
+    if (sys.abort) {
+      fprintf(stderr, "grbl_estimate: %s line %u: aborted\n", estimate_path, estimate_lines);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Leaving check mode completes the motion and reports the total time.
+  system_execute_line(check_mode);
+
+  printf("line,seconds\n");
+  uint32_t idx;
+  for (idx = 0; idx < estimate_lines; idx++) {
+    if (estimate_line_seconds[idx] > 0.0) { printf("%u,%.3f\n", idx+1, estimate_line_seconds[idx]); }
+  }
+  printf("total,%.3f\n", estimate_total_seconds);
+  exit(errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+static void estimate_usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [options] file.nc\n"
+    "  Estimates the execution time of a g-code file in check mode and prints CSV results, the time\n"
+    "  of each line with motion and the total time.\n"
+    "  -e file   Use the settings of this EEPROM file of grbl_sim (default: the default settings)\n", name);
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+  const char *eeprom_path = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "e:")) != -1) {
+    switch (opt) {
+      case 'e': eeprom_path = optarg; break;
+      default: estimate_usage(argv[0]);
+    }
+  }
+  if (optind != argc-1) { estimate_usage(argv[0]); }
+  estimate_path = argv[optind];
+  estimate_file = fopen(estimate_path, "r");
+  if (estimate_file == NULL) { perror(estimate_path); return(EXIT_FAILURE); }
+
+  sim_eeprom_init(eeprom_path);
+  grbl_main();
+  return(EXIT_FAILURE); // Never reached
+}
@@ -0,0 +1,229 @@
+/*
+  read_float_test.c - Host differential test and benchmark of read_float()
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Compares the host read_float() with the AVR read_float(), which is the original implementation,
+  on random g-code words, and measures the time per word of both. nuts_bolts.c is built once as
+  usual and once with __AVR__ defined, and the Makefile renames read_float() of each build.
+
+  Both must accept the same words and return the same character index. The values must be equal,
+  or the host value must be the nearest float of the decimal, as truncated to MAX_INT_DIGITS
+  digits. The host value must always be the nearest float, when its exact division applies.
+*/
+
+#include "../grbl/grbl.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READ_FLOAT_TEST_WORDS 2000000 // Default number of random words compared.
+#define READ_FLOAT_TEST_BENCH_WORDS 4096 // Words per benchmark run.
+#define READ_FLOAT_TEST_BENCH_RUNS 40 // The best of these runs is reported.
+#define READ_FLOAT_TEST_DIGITS 8 // MAX_INT_DIGITS of nuts_bolts.c
+#define READ_FLOAT_TEST_EXACT_MAX 16777216 // EXACT_FLOAT_INT_MAX of nuts_bolts.c
+
+// Globals of the Grbl modules not linked into the test.
+system_t sys;
+void protocol_execute_realtime() { }
+void protocol_exec_rt_system() { }
+void sim_delay_us(double us) { }
+
+uint8_t read_float_avr(char *line, uint8_t *char_counter, float *float_ptr);
+uint8_t read_float_host(char *line, uint8_t *char_counter, float *float_ptr);
+
+static uint32_t read_float_test_seed = 1;
+static uint32_t read_float_test_failures;
+static uint32_t read_float_test_rounded; // Words read closer to the decimal than by the original.
+
+
+// Xorshift generator, so that every run tests the same words.
+static uint32_t read_float_test_random()
+{
+  read_float_test_seed ^= read_float_test_seed << 13;
+  read_float_test_seed ^= read_float_test_seed >> 17;
+  read_float_test_seed ^= read_float_test_seed << 5;
+  return(read_float_test_seed);
+}
+
+
+// Writes a random word value into text, after a word letter, followed by the next word. Mostly
+// typical coordinates, and otherwise long digit runs, signs, stray dots and letters.
+static void read_float_test_word(char *text)
+{
+  char *c = text;
+  *c++ = 'X';
+  uint32_t kind = read_float_test_random() % 8;
+  if (kind < 4) {
+    float value = (int32_t)(read_float_test_random() % 2000000 - 1000000)/1000.0;
+    c += sprintf(c, (kind == 0) ? "%.4f" : "%.3f", value);
+  } else {
+    uint8_t length = read_float_test_random() % 16;
+    while (length--) {
+      uint32_t r = read_float_test_random() % 32;
+      if (r < 24) { *c++ = '0' + r % 10; }
+      else if (r < 27) { *c++ = '.'; }
+      else if (r < 29) { *c++ = (r == 27) ? '-' : '+'; }
+      else { *c++ = 'A' + read_float_test_random() % 26; }
+    }
+  }
+  strcpy(c, "Y1");
+}
+
+
+// Nearest float of the decimal, as read_float() truncates it to MAX_INT_DIGITS digits. Sets exact,
+// if the host read_float() converts it with its exact division.
+static float read_float_test_nearest(char *text, uint8_t start, bool *exact)
+{
+  char *c = text + start;
+  bool isnegative = (*c == '-');
+  if ((*c == '-') || (*c == '+')) { c++; }
+  char digits[32];
+  uint8_t ndigit = 0;
+  int8_t exp = 0;
+  bool isdecimal = false;
+  for (;; c++) {
+    if ((*c >= '0') && (*c <= '9')) {
+      if (ndigit < READ_FLOAT_TEST_DIGITS) {
+        digits[ndigit++] = *c;
+        if (isdecimal) { exp--; }
+      } else if (!isdecimal) {
+        exp++;
+      }
+    } else if ((*c == '.') && !isdecimal) {
+      isdecimal = true;
+    } else {
+      break;
+    }
+  }
+  digits[ndigit] = 0;
+  *exact = (exp < 0) && (strtoul(digits, NULL, 10) <= READ_FLOAT_TEST_EXACT_MAX);
+  sprintf(digits+ndigit, "e%d", exp);
+  float value = strtof(digits, NULL);
+  return(isnegative ? -value : value);
+}
+
+
+static void read_float_test_compare(char *text)
+{
+  uint8_t avr_counter = 1, host_counter = 1;
+  float avr_value = 0.0, host_value = 0.0;
+  uint8_t avr_result = read_float_avr(text, &avr_counter, &avr_value);
+  uint8_t host_result = read_float_host(text, &host_counter, &host_value);
+  if ((avr_result != host_result) || (avr_counter != host_counter)) {
+    printf("FAIL: '%s' returns %u at %u, expected %u at %u\n", text, host_result, host_counter,
+           avr_result, avr_counter);
+    read_float_test_failures++;
+    return;
+  }
+  if (!avr_result) { return; }
+  bool exact;
+  float nearest = read_float_test_nearest(text, 1, &exact);
+  if (memcmp(&avr_value, &host_value, sizeof(float)) == 0) {
+    if (!exact || (host_value == nearest)) { return; }
+  } else {
+    read_float_test_rounded++;
+    if (host_value == nearest) { return; }
+  }
+  printf("FAIL: '%s' reads %.9g, the original %.9g, the nearest float %.9g\n", text, host_value,
+         avr_value, nearest);
+  read_float_test_failures++;
+}
+
+
+static double read_float_test_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return(ts.tv_sec + ts.tv_nsec/1e9);
+}
+
+
+// Best time per word, in ns, of reading the given words.
+static double read_float_test_bench(uint8_t (*read)(char *, uint8_t *, float *), char (*words)[16])
+{
+  double best = 1e9;
+  volatile float sum = 0.0;
+  uint8_t run;
+  for (run = 0; run < READ_FLOAT_TEST_BENCH_RUNS; run++) {
+    double start = read_float_test_time();
+    uint16_t idx;
+    for (idx = 0; idx < READ_FLOAT_TEST_BENCH_WORDS; idx++) {
+      uint8_t counter = 1;
+      float value;
+      read(words[idx], &counter, &value);
+      sum += value;
+    }
+    double ns = 1e9*(read_float_test_time()-start)/READ_FLOAT_TEST_BENCH_WORDS;
+    if (ns < best) { best = ns; }
+  }
+  return(best);
+}
+
+
+int main(int argc, char *argv[])
+{
+  uint32_t count = READ_FLOAT_TEST_WORDS;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:")) != -1) {
+    switch (opt) {
+      case 'n': count = strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "Usage: %s [-n words]\n", argv[0]);
+        return(EXIT_FAILURE);
+    }
+  }
+
+  // Edge cases, then random words.
+  static const char *cases[] = { "X0", "X-0", "X+.5", "X.", "X-", "X1.2.3", "X123456789.5",
+    "X99999999999", "X0.000000001", "X16777216.1", "X16777217.1", "X-0.1", "X8388607.5", "X" };
+  char text[40];
+  uint8_t idx;
+  for (idx = 0; idx < sizeof(cases)/sizeof(cases[0]); idx++) {
+    strcpy(text, cases[idx]);
+    read_float_test_compare(text);
+  }
+  uint32_t n;
+  for (n = 0; n < count; n++) {
+    read_float_test_word(text);
+    read_float_test_compare(text);
+  }
+
+  // Time per word of typical coordinates.
+  static char words[READ_FLOAT_TEST_BENCH_WORDS][16];
+  uint16_t word;
+  for (word = 0; word < READ_FLOAT_TEST_BENCH_WORDS; word++) {
+    float value = (int32_t)(read_float_test_random() % 2000000 - 1000000)/1000.0;
+    sprintf(words[word], "X%.3fY", value);
+  }
+  double avr_ns = read_float_test_bench(read_float_avr, words);
+  double host_ns = read_float_test_bench(read_float_host, words);
+  printf("implementation,ns_per_word\n");
+  printf("avr,%.1f\n", avr_ns);
+  printf("host,%.1f\n", host_ns);
+
+  if (read_float_test_failures) {
+    printf("read_float_test: %u of %u words failed\n", read_float_test_failures, count);
+    return(EXIT_FAILURE);
+  }
+  printf("read_float_test: %u words passed, %u rounded to nearest unlike the original\n", count,
+         read_float_test_rounded);
+  return(EXIT_SUCCESS);
+}
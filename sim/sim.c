@@ -0,0 +1,414 @@
+/*
+  sim.c - Runs the Grbl firmware as a Linux process behind a pseudo-terminal
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  The unmodified Grbl sources are compiled against the register shims in this directory. The Grbl
+  main program runs on the process main thread. A hardware thread keeps a virtual CPU clock in step
+  with the wall clock and schedules the interrupts of the stepper timers, the spindle timer and the
+  UART from the register contents. Each interrupt is executed on the main thread by a signal, which
+  preempts the main program at an arbitrary point like the real interrupt does, and is held off
+  while the SREG interrupt flag is clear.
+
+  UART bytes are exchanged with a pseudo-terminal, one byte per frame time of the programmed or
+  given baud rate, through the serial.c ring buffers and interrupts. The stepper interrupt consumes
+  the segment buffer at its programmed timer rate in virtual time. Step and limit pins are not
+  simulated.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <avr/io.h>
+#include "sim.h"
+
+#define SIM_NEVER UINT64_MAX
+#define SIM_RX_QUEUE_SIZE 4096
+#define SIM_TX_QUEUE_SIZE 4096
+#define SIM_MAX_WAIT_NS 1000000 // Longest hardware thread sleep between input polls.
+#define SIM_MAX_LAG (F_CPU/10) // Virtual time dropped when the hardware thread falls behind.
+
+int grbl_main(void);
+
+
+// Command line options.
+static double sim_speed = 1.0;
+static uint32_t sim_baud_rate;
+static const char *sim_link_path;
+
+static pthread_t sim_main_thread;
+
+
+// Interrupt execution. The hardware thread posts a vector and signals the main thread, which runs
+// it in the signal handler, or declines it while interrupts are disabled, and reports back. The
+// handler yields afterwards, so a single processor goes back to the waiting hardware thread instead
+// of the busy main program. Interrupts don't nest, as the hardware thread waits for each one.
+#define SIM_INTERRUPT_PENDING  0
+#define SIM_INTERRUPT_DONE     1
+#define SIM_INTERRUPT_DECLINED 2
+
+static void (*volatile sim_interrupt_vector)(void);
+static volatile int sim_interrupt_result;
+
+static void sim_interrupt_handler(int signum)
+{
+  (void)signum;
+  if (!(SREG & 0x80)) {
+    __atomic_store_n(&sim_interrupt_result, SIM_INTERRUPT_DECLINED, __ATOMIC_RELEASE);
+    sched_yield();
+    return;
+  }
+  SREG &= ~0x80; // Interrupts are disabled on entry, as by the hardware.
+  sim_interrupt_vector();
+  SREG |= 0x80;
+  __atomic_store_n(&sim_interrupt_result, SIM_INTERRUPT_DONE, __ATOMIC_RELEASE);
+  sched_yield();
+}
+
+void sim_cli() { SREG &= ~0x80; }
+
+static void sim_interrupt(void (*vector)(void))
+{
+  if (vector == NULL) { return; }
+  sim_interrupt_vector = vector;
+  for (;;) {
+    __atomic_store_n(&sim_interrupt_result, SIM_INTERRUPT_PENDING, __ATOMIC_RELEASE);
+    pthread_kill(sim_main_thread, SIGUSR1);
+    int result;
+    while ((result = __atomic_load_n(&sim_interrupt_result, __ATOMIC_ACQUIRE)) == SIM_INTERRUPT_PENDING) {
+      sched_yield();
+    }
+    if (result == SIM_INTERRUPT_DONE) { return; }
+    sched_yield(); // Interrupts disabled. Retry until the main program enables them.
+  }
+}
+
+
+// Virtual CPU clock in cycles since start-up.
+static uint64_t sim_cycles;
+
+static const uint16_t sim_timer01_prescaler[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+static const uint16_t sim_timer2_prescaler[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+
+// 8-bit timers count up to 0xff and wrap, in normal and fast PWM modes alike. The overflow and
+// compare match interrupts are timed from the counter, which is brought up to date before every
+// interrupt, so it reflects writes by the interrupts themselves.
+typedef struct {
+  volatile uint8_t *tccrb, *tcnt, *timsk, *ocra, *ocrb;
+  const uint16_t *prescaler;
+  void (*ovf_vector)(void), (*compa_vector)(void), (*compb_vector)(void);
+  uint64_t tick_time; // Time of the last counter increment.
+} sim_timer8_t;
+
+static sim_timer8_t sim_timer0 = { &TCCR0B, &TCNT0, &TIMSK0, &OCR0A, &OCR0B, sim_timer01_prescaler,
+                                   TIMER0_OVF_vect, TIMER0_COMPA_vect, NULL };
+static sim_timer8_t sim_timer2 = { &TCCR2B, &TCNT2, &TIMSK2, &OCR2A, &OCR2B, sim_timer2_prescaler,
+                                   TIMER2_OVF_vect, NULL, TIMER2_COMPB_vect };
+
+static void sim_timer8_update(sim_timer8_t *t, uint64_t time)
+{
+  uint16_t prescaler = t->prescaler[*t->tccrb & 0x07];
+  if (prescaler == 0) { t->tick_time = time; return; } // Stopped
+  uint64_t ticks = (time - t->tick_time)/prescaler;
+  *t->tcnt += (uint8_t)ticks;
+  t->tick_time += ticks*prescaler;
+}
+
+static uint64_t sim_timer8_next(sim_timer8_t *t)
+{
+  uint16_t prescaler = t->prescaler[*t->tccrb & 0x07];
+  if (prescaler == 0) { return(SIM_NEVER); }
+  uint8_t count = *t->tcnt;
+  uint16_t ticks = UINT16_MAX;
+  if ((*t->timsk & (1<<TOIE0)) && t->ovf_vector) { ticks = 256-count; }
+  if ((*t->timsk & (1<<OCIE0A)) && t->compa_vector) {
+    uint8_t match = *t->ocra-count;
+    if ((match ? match : 256) < ticks) { ticks = (match ? match : 256); }
+  }
+  if ((*t->timsk & (1<<OCIE0B)) && t->compb_vector) {
+    uint8_t match = *t->ocrb-count;
+    if ((match ? match : 256) < ticks) { ticks = (match ? match : 256); }
+  }
+  if (ticks == UINT16_MAX) { return(SIM_NEVER); }
+  return(t->tick_time + (uint64_t)ticks*prescaler);
+}
+
+static void sim_timer8_execute(sim_timer8_t *t)
+{
+  uint8_t count = *t->tcnt;
+  uint8_t timsk = *t->timsk;
+  if ((timsk & (1<<OCIE0A)) && (count == *t->ocra)) { sim_interrupt(t->compa_vector); }
+  if ((timsk & (1<<OCIE0B)) && (count == *t->ocrb)) { sim_interrupt(t->compb_vector); }
+  if ((timsk & (1<<TOIE0)) && (count == 0)) { sim_interrupt(t->ovf_vector); }
+}
+
+
+// Timer1 runs in CTC mode, with the compare match interrupt after OCR1A+1 ticks. The period is
+// read again after each interrupt, as the stepper interrupt reprograms it for the next one.
+static uint64_t sim_timer1_next = SIM_NEVER;
+
+static uint64_t sim_timer1_period()
+{
+  if (!(TIMSK1 & (1<<OCIE1A))) { return(0); }
+  return((uint64_t)(OCR1A+1)*sim_timer01_prescaler[TCCR1B & 0x07]);
+}
+
+
+// UART frames. Received bytes queue up from the pseudo-terminal and complete one frame time apart.
+// Transmitted bytes are taken one frame time apart while the data register empty interrupt is on.
+static int sim_pty_fd;
+static uint8_t sim_rx_queue[SIM_RX_QUEUE_SIZE];
+static uint16_t sim_rx_head, sim_rx_tail;
+static uint64_t sim_rx_next = SIM_NEVER;
+static uint8_t sim_tx_queue[SIM_TX_QUEUE_SIZE];
+static uint16_t sim_tx_count;
+static uint64_t sim_tx_ready;
+
+static uint64_t sim_uart_frame_cycles()
+{
+  if (sim_baud_rate) { return((uint64_t)10*F_CPU/sim_baud_rate); } // 8N1 frame of 10 bits
+  uint16_t ubrr = (UBRR0H << 8) | UBRR0L;
+  return((uint64_t)10*(ubrr+1)*((UCSR0A & (1<<U2X0)) ? 8 : 16));
+}
+
+static void sim_uart_receive_pty()
+{
+  for (;;) {
+    uint16_t next_head = (sim_rx_head+1) % SIM_RX_QUEUE_SIZE;
+    if (next_head == sim_rx_tail) { return; } // Queue full. Leave the rest in the pseudo-terminal.
+    uint8_t data;
+    if (read(sim_pty_fd, &data, 1) != 1) { return; }
+    if (sim_rx_head == sim_rx_tail) { sim_rx_next = sim_cycles+sim_uart_frame_cycles(); }
+    sim_rx_queue[sim_rx_head] = data;
+    sim_rx_head = next_head;
+  }
+}
+
+static void sim_uart_transmit_pty()
+{
+  if (sim_tx_count == 0) { return; }
+  ssize_t count = write(sim_pty_fd, sim_tx_queue, sim_tx_count);
+  if (count <= 0) { return; } // Pseudo-terminal full. Transmission stalls until the host reads.
+  sim_tx_count -= count;
+  memmove(sim_tx_queue, sim_tx_queue+count, sim_tx_count);
+}
+
+static uint64_t sim_uart_tx_next()
+{
+  if (!(UCSR0B & (1<<UDRIE0)) || (sim_tx_count == SIM_TX_QUEUE_SIZE)) { return(SIM_NEVER); }
+  return((sim_tx_ready > sim_cycles) ? sim_tx_ready : sim_cycles);
+}
+
+
+// Executes all interrupts due up to the given virtual time, in time order.
+static void sim_execute_until(uint64_t time)
+{
+  for (;;) {
+    uint64_t timer0_next = sim_timer8_next(&sim_timer0);
+    uint64_t timer2_next = sim_timer8_next(&sim_timer2);
+    uint64_t tx_next = sim_uart_tx_next();
+
+    uint64_t next = sim_timer1_next;
+    if (timer0_next < next) { next = timer0_next; }
+    if (timer2_next < next) { next = timer2_next; }
+    if (sim_rx_next < next) { next = sim_rx_next; }
+    if (tx_next < next) { next = tx_next; }
+    if (next > time) { break; }
+
+    sim_cycles = next;
+    sim_timer8_update(&sim_timer0, next);
+    sim_timer8_update(&sim_timer2, next);
+    if (next == sim_timer1_next) {
+      sim_interrupt(TIMER1_COMPA_vect);
+      uint64_t period = sim_timer1_period();
+      sim_timer1_next = (period ? next+period : SIM_NEVER);
+    } else if (next == timer0_next) {
+      sim_timer8_execute(&sim_timer0);
+    } else if (next == timer2_next) {
+      sim_timer8_execute(&sim_timer2);
+    } else if (next == sim_rx_next) {
+      if (UCSR0B & (1<<RXCIE0)) {
+        UDR0 = sim_rx_queue[sim_rx_tail];
+        sim_interrupt(USART_RX_vect);
+      } // Otherwise the byte is lost, as with the receiver disabled.
+      sim_rx_tail = (sim_rx_tail+1) % SIM_RX_QUEUE_SIZE;
+      sim_rx_next = (sim_rx_head == sim_rx_tail ? SIM_NEVER : next+sim_uart_frame_cycles());
+    } else {
+      sim_interrupt(USART_UDRE_vect);
+      sim_tx_queue[sim_tx_count++] = UDR0;
+      sim_tx_ready = next+sim_uart_frame_cycles();
+    }
+  }
+  sim_cycles = time;
+  sim_timer8_update(&sim_timer0, time);
+  sim_timer8_update(&sim_timer2, time);
+}
+
+
+static uint64_t sim_wall_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return((uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec);
+}
+
+static uint64_t sim_ns_to_cycles(uint64_t ns) { return((uint64_t)(ns*sim_speed*(F_CPU/1e9))); }
+
+
+static void *sim_hardware_thread(void *arg)
+{
+  (void)arg;
+  uint64_t start_ns = sim_wall_ns();
+  uint64_t start_cycles = 0;
+  for (;;) {
+    uint64_t time = start_cycles+sim_ns_to_cycles(sim_wall_ns()-start_ns);
+    if (time > sim_cycles+SIM_MAX_LAG) { // Behind. Drop the lag instead of catching up in a burst.
+      start_cycles -= time-(sim_cycles+SIM_MAX_LAG);
+      time = sim_cycles+SIM_MAX_LAG;
+    }
+
+    // Start the stepper timer when the main program enables its interrupt. The interrupt itself
+    // keeps it running or stops it.
+    if (sim_timer1_next == SIM_NEVER) {
+      uint64_t period = sim_timer1_period();
+      if (period) { sim_timer1_next = sim_cycles+period; }
+    }
+
+    sim_uart_receive_pty();
+    sim_execute_until(time);
+    sim_uart_transmit_pty();
+
+    // Sleep until the next interrupt is due or the host sends data.
+    uint64_t next = sim_timer1_next;
+    uint64_t timer0_next = sim_timer8_next(&sim_timer0);
+    uint64_t timer2_next = sim_timer8_next(&sim_timer2);
+    uint64_t tx_next = sim_uart_tx_next();
+    if (timer0_next < next) { next = timer0_next; }
+    if (timer2_next < next) { next = timer2_next; }
+    if (sim_rx_next < next) { next = sim_rx_next; }
+    if (tx_next < next) { next = tx_next; }
+    uint64_t wait_ns = SIM_MAX_WAIT_NS;
+    if ((next-time)/(sim_speed*(F_CPU/1e9)) < wait_ns) { wait_ns = (next-time)/(sim_speed*(F_CPU/1e9)); }
+    struct timespec timeout = { 0, wait_ns };
+    struct pollfd pfd = { sim_pty_fd, (sim_tx_count ? POLLIN|POLLOUT : POLLIN), 0 };
+    ppoll(&pfd, 1, &timeout, NULL);
+  }
+  return(NULL);
+}
+
+
+void sim_delay_us(double us)
+{
+  struct timespec ts;
+  double ns = us*1000.0/sim_speed;
+  ts.tv_sec = ns/1e9;
+  ts.tv_nsec = ns-ts.tv_sec*1e9;
+  while (nanosleep(&ts, &ts) && (errno == EINTR)) { } // Resume after serviced interrupts.
+}
+
+
+static void sim_exit(int signum)
+{
+  (void)signum;
+  sim_eeprom_sync(); // Complete a started EEPROM write.
+  if (sim_link_path) { unlink(sim_link_path); }
+  _exit(EXIT_SUCCESS);
+}
+
+
+static void sim_usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [options]\n"
+    "  -b baud   Pace the UART at this baud rate instead of the programmed one\n"
+    "  -e file   Keep the EEPROM contents in this file (default: erased at every start)\n"
+    "  -l path   Create a symbolic link to the pseudo-terminal at this path\n"
+    "  -p dir    Keep stored programs as files in this directory (default: none)\n"
+    "  -s speed  Run the virtual time this many times faster than real time (default: 1)\n", name);
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+  const char *eeprom_path = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "b:e:l:p:s:")) != -1) {
+    switch (opt) {
+      case 'b': sim_baud_rate = strtoul(optarg, NULL, 10); break;
+      case 'e': eeprom_path = optarg; break;
+      case 'l': sim_link_path = optarg; break;
+      case 'p': sim_storage_init(optarg); break;
+      case 's': sim_speed = strtod(optarg, NULL); if (sim_speed <= 0) { sim_usage(argv[0]); } break;
+      default: sim_usage(argv[0]);
+    }
+  }
+  sim_eeprom_init(eeprom_path);
+
+  // Open the pseudo-terminal in raw mode. The slave end stays open, so the master doesn't report
+  // a hang-up while no host is connected.
+  sim_pty_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((sim_pty_fd < 0) || grantpt(sim_pty_fd) || unlockpt(sim_pty_fd)) { perror("grbl_sim: pty"); return(EXIT_FAILURE); }
+  const char *slave_path = ptsname(sim_pty_fd);
+  int slave_fd = open(slave_path, O_RDWR | O_NOCTTY);
+  struct termios tio;
+  if ((slave_fd < 0) || tcgetattr(slave_fd, &tio)) { perror(slave_path); return(EXIT_FAILURE); }
+  cfmakeraw(&tio);
+  tcsetattr(slave_fd, TCSANOW, &tio);
+  fcntl(sim_pty_fd, F_SETFL, O_NONBLOCK);
+  if (sim_link_path) {
+    unlink(sim_link_path);
+    if (symlink(slave_path, sim_link_path)) { perror(sim_link_path); return(EXIT_FAILURE); }
+  }
+  fprintf(stderr, "grbl_sim: %s\n", sim_link_path ? sim_link_path : slave_path);
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = sim_exit;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sigaction(SIGHUP, &sa, NULL);
+  sa.sa_handler = sim_interrupt_handler;
+  sigaction(SIGUSR1, &sa, NULL);
+
+  // Interrupt signals are taken only by the main thread.
+  sigset_t set, old_set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR1);
+  sim_main_thread = pthread_self();
+  pthread_sigmask(SIG_BLOCK, &set, &old_set);
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, sim_hardware_thread, NULL)) { perror("grbl_sim: thread"); return(EXIT_FAILURE); }
+  pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+
+  return(grbl_main());
+}
@@ -0,0 +1,44 @@
+/*
+  sim.h - Shared declarations of the Grbl simulator and benchmark
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef sim_h
+#define sim_h
+
+// Interrupt vectors. Those of disabled Grbl features are not linked in.
+#define SIM_VECTOR(vector) void vector(void) __attribute__((weak));
+SIM_VECTOR(TIMER1_COMPA_vect)
+SIM_VECTOR(TIMER0_OVF_vect)
+SIM_VECTOR(TIMER0_COMPA_vect)
+SIM_VECTOR(TIMER2_OVF_vect)
+SIM_VECTOR(TIMER2_COMPB_vect)
+SIM_VECTOR(USART_RX_vect)
+SIM_VECTOR(USART_UDRE_vect)
+
+// Loads the EEPROM contents from the given file, which keeps all later writes. Without a file,
+// the EEPROM starts erased.
+void sim_eeprom_init(const char *path);
+
+// Completes a started EEPROM write. Called before exiting.
+void sim_eeprom_sync();
+
+// Keeps the stored programs as files in the given directory. Without a directory, none are stored.
+void sim_storage_init(const char *path);
+
+#endif
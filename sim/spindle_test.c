@@ -0,0 +1,149 @@
+/*
+  spindle_test.c - Host test of the spindle PWM models
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Compares the lookup table spindle model of ENABLE_SPINDLE_PWM_TABLE with the default linear model
+  and the ENABLE_PIECEWISE_LINEAR_SPINDLE model, over an rpm sweep. spindle_control.c is built once
+  per model, and the Makefile renames spindle_init() and spindle_compute_pwm_value() of each build
+  with the model name. The config.h table and piecewise solutions are both solutions of the example
+  spindle data in 'fit_nonlinear_spindle.py', which is repeated below. Each model is compared with
+  the measured data. The table must match it at least as well as the piecewise model, besides being
+  monotonic, hitting its entries at the table rpms, and limiting to its end values.
+*/
+
+#include "../grbl/grbl.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define SPINDLE_TEST_RPM_STEP 1.0 // Rpm step of the monotonic sweep.
+#define N_SPINDLE_TEST_DATA 15
+
+// Programmed PWM values and measured spindle rpms of 'fit_nonlinear_spindle.py'.
+static const float spindle_test_pwm_set[N_SPINDLE_TEST_DATA] =
+  { 2, 18, 36, 55, 73, 91, 109, 127, 146, 164, 182, 200, 218, 237, 254 };
+static const float spindle_test_rpm_measured[N_SPINDLE_TEST_DATA] =
+  { 213, 5420, 7145, 8282, 9165, 9765, 10100, 10500, 10700, 10900, 11100, 11250, 11400, 11550, 11650 };
+
+// Globals of the Grbl modules not linked into the test.
+settings_t settings;
+system_t sys;
+void protocol_buffer_synchronize() { }
+
+void spindle_init_linear();
+void spindle_init_piecewise();
+void spindle_init_table();
+spindle_pwm_t spindle_compute_pwm_value_linear(float rpm);
+spindle_pwm_t spindle_compute_pwm_value_piecewise(float rpm);
+spindle_pwm_t spindle_compute_pwm_value_table(float rpm);
+
+static const uint8_t spindle_test_table[N_PWM_TABLE] = SPINDLE_PWM_TABLE;
+static uint16_t spindle_test_failures;
+
+
+static void spindle_test_check(bool pass, const char *format, ...)
+{
+  if (pass) { return; }
+  va_list args;
+  va_start(args, format);
+  printf("FAIL: ");
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+  spindle_test_failures++;
+}
+
+
+static float spindle_test_counts(spindle_pwm_t pwm_value) { return((float)pwm_value/SPINDLE_PWM_SCALE); }
+
+
+int main()
+{
+  // Spindle range of the piecewise model. The table model only checks for a valid range.
+  settings.rpm_max = RPM_MAX;
+  settings.rpm_min = RPM_MIN;
+  sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE;
+  spindle_init_linear();
+  spindle_init_piecewise();
+  spindle_init_table();
+
+  // Limits. S0 is off, and rpms outside of the table limit to the table end values.
+  spindle_test_check(spindle_compute_pwm_value_table(0.0) == SPINDLE_PWM_OFF_VALUE,
+                     "S0 table PWM %.2f, expected off",
+                     spindle_test_counts(spindle_compute_pwm_value_table(0.0)));
+  float limit_rpm[4] = { 1.0, RPM_TABLE_MIN, RPM_TABLE_MAX, 2*RPM_TABLE_MAX };
+  float limit_pwm[4] = { spindle_test_table[0], spindle_test_table[0],
+                         spindle_test_table[N_PWM_TABLE-1], spindle_test_table[N_PWM_TABLE-1] };
+  uint8_t idx;
+  for (idx = 0; idx < 4; idx++) {
+    float pwm = spindle_test_counts(spindle_compute_pwm_value_table(limit_rpm[idx]));
+    spindle_test_check(pwm == limit_pwm[idx], "S%.1f table PWM %.2f, expected end value %.2f",
+                       limit_rpm[idx], pwm, limit_pwm[idx]);
+  }
+
+  // Table entries at their rpms. Allow for the rounding of the 8.8 fixed-point table position.
+  for (idx = 0; idx < N_PWM_TABLE; idx++) {
+    float rpm = RPM_TABLE_MIN + idx*((RPM_TABLE_MAX-RPM_TABLE_MIN)/(N_PWM_TABLE-1));
+    float pwm = spindle_test_counts(spindle_compute_pwm_value_table(rpm));
+    spindle_test_check(fabs(pwm-spindle_test_table[idx]) <= 1.0, "S%.1f table PWM %.2f, expected entry %.2f",
+                       rpm, pwm, (float)spindle_test_table[idx]);
+  }
+
+  // The table output must not decrease with rpm.
+  float last_pwm = 0.0;
+  float rpm;
+  for (rpm = RPM_TABLE_MIN; rpm <= RPM_TABLE_MAX; rpm += SPINDLE_TEST_RPM_STEP) {
+    float pwm = spindle_test_counts(spindle_compute_pwm_value_table(rpm));
+    spindle_test_check(pwm >= last_pwm, "S%.1f table PWM %.2f, below the PWM %.2f of a lower rpm",
+                       rpm, pwm, last_pwm);
+    last_pwm = pwm;
+  }
+
+  // Error of each model at the measured data, in PWM counts.
+  float max_error[3] = { 0.0, 0.0, 0.0 };
+  float sum_error[3] = { 0.0, 0.0, 0.0 };
+  for (idx = 0; idx < N_SPINDLE_TEST_DATA; idx++) {
+    float rpm = spindle_test_rpm_measured[idx];
+    float error[3] = {
+      fabs(spindle_test_counts(spindle_compute_pwm_value_linear(rpm))-spindle_test_pwm_set[idx]),
+      fabs(spindle_test_counts(spindle_compute_pwm_value_piecewise(rpm))-spindle_test_pwm_set[idx]),
+      fabs(spindle_test_counts(spindle_compute_pwm_value_table(rpm))-spindle_test_pwm_set[idx]) };
+    uint8_t model;
+    for (model = 0; model < 3; model++) {
+      max_error[model] = max(max_error[model], error[model]);
+      sum_error[model] += error[model];
+    }
+  }
+  spindle_test_check(max_error[2] <= max_error[1], "Table max error %.2f, piecewise %.2f",
+                     max_error[2], max_error[1]);
+  spindle_test_check(sum_error[2] <= sum_error[1], "Table total error %.2f, piecewise %.2f",
+                     sum_error[2], sum_error[1]);
+
+  printf("model,max_pwm_error,mean_pwm_error\n");
+  printf("linear,%.2f,%.2f\n", max_error[0], sum_error[0]/N_SPINDLE_TEST_DATA);
+  printf("piecewise,%.2f,%.2f\n", max_error[1], sum_error[1]/N_SPINDLE_TEST_DATA);
+  printf("table,%.2f,%.2f\n", max_error[2], sum_error[2]/N_SPINDLE_TEST_DATA);
+  if (spindle_test_failures) {
+    printf("spindle_test: %u checks failed\n", spindle_test_failures);
+    return(EXIT_FAILURE);
+  }
+  printf("spindle_test: passed\n");
+  return(EXIT_SUCCESS);
+}
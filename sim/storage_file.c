@@ -0,0 +1,98 @@
+/*
+  storage_file.c - File-backed program storage device of the Grbl simulator and benchmark
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../grbl/grbl.h"
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sim.h"
+
+#ifdef ENABLE_PROGRAM_STORAGE
+
+// Stored programs are the files '<number>.nc' of the storage directory. Files copied there by the
+// host run the same as uploaded programs.
+static const char *sim_storage_path;
+static FILE *sim_storage_file;
+
+
+void sim_storage_init(const char *path)
+{
+  sim_storage_path = path;
+}
+
+
+static const char *sim_storage_file_name(uint8_t program)
+{
+  static char name[4096];
+  snprintf(name, sizeof(name), "%s/%u.nc", sim_storage_path, program);
+  return(name);
+}
+
+
+uint8_t storage_device_open(uint8_t program, uint8_t write)
+{
+  if (sim_storage_path == NULL) { return(false); }
+  sim_storage_file = fopen(sim_storage_file_name(program), write ? "w" : "r");
+  return(sim_storage_file != NULL);
+}
+
+
+int16_t storage_device_read()
+{
+  int c = getc(sim_storage_file);
+  if (c == EOF) { return(STORAGE_END_OF_PROGRAM); }
+  return(c);
+}
+
+
+uint8_t storage_device_write(uint8_t c)
+{
+  return(putc(c, sim_storage_file) != EOF);
+}
+
+
+void storage_device_close()
+{
+  if (sim_storage_file != NULL) {
+    fclose(sim_storage_file);
+    sim_storage_file = NULL;
+  }
+}
+
+
+uint8_t storage_device_size(uint8_t program, uint32_t *size)
+{
+  struct stat st;
+  if ((sim_storage_path == NULL) || stat(sim_storage_file_name(program), &st)) { return(false); }
+  *size = st.st_size;
+  return(true);
+}
+
+
+void storage_device_delete(uint8_t program)
+{
+  if (sim_storage_path != NULL) { unlink(sim_storage_file_name(program)); }
+}
+
+#else
+
+void sim_storage_init(const char *path) { (void)path; }
+
+#endif
@@ -0,0 +1,394 @@
+/*
+  stream.c - Character-counting g-code streaming client
+  Part of Grbl
+
+  Copyright (c) 2026 agent
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Streams a g-code file to Grbl on a serial device, or on the pseudo-terminal of grbl_sim, and
+  measures the streaming throughput. It is the native counterpart of doc/script/stream.py.
+
+  Lines are sent with the character-counting protocol. The client counts the characters of every
+  line sent to Grbl that is not yet answered by 'ok' or 'error', and sends the next line as soon as
+  it fits the Grbl serial RX buffer. The RX buffer size is read from the '$I' build option line. So
+  the buffer stays full, and the planner is fed as fast as Grbl can parse. Realtime commands, like
+  status queries, feed holds or overrides, bypass the RX buffer and are interleaved with the lines
+  as they are due, without being counted.
+
+  The send-to-response latency of every line is measured, from writing its last character to
+  reading its response. The lines/sec throughput and latency statistics are printed at the end, and
+  each line can be logged to a CSV file.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STREAM_RX_BUFFER_SIZE 128 // Grbl serial RX buffer size, if not reported by '$I'.
+#define STREAM_LINE_SIZE 256      // Longest line sent or received.
+#define STREAM_MAX_REALTIME 64    // Realtime commands scheduled on the command line.
+
+// Streamed line. Lines are kept for the latency log and statistics.
+typedef struct {
+  uint16_t length;     // Characters sent, with the line feed
+  uint8_t status;      // Error code of the response. Zero for 'ok'.
+  uint32_t file_line;  // Line number in the file
+  double sent;         // Time the line was sent
+  double latency;      // Seconds from sending the line to its response
+} stream_line_t;
+
+// Realtime command sent after the given line.
+typedef struct {
+  uint32_t line;
+  uint8_t command;
+} stream_realtime_t;
+
+static int stream_fd;
+static char stream_rx_line[STREAM_LINE_SIZE];
+static uint16_t stream_rx_length;
+static bool stream_verbose;
+
+
+static double stream_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return(ts.tv_sec + ts.tv_nsec/1e9);
+}
+
+
+static void stream_write(const char *data, size_t length)
+{
+  while (length) {
+    ssize_t count = write(stream_fd, data, length);
+    if (count < 0) {
+      if ((errno == EAGAIN) || (errno == EINTR)) {
+        struct pollfd pfd = { stream_fd, POLLOUT, 0 };
+        poll(&pfd, 1, 100);
+        continue;
+      }
+      perror("grbl_stream: write");
+      exit(EXIT_FAILURE);
+    }
+    data += count;
+    length -= count;
+  }
+}
+
+
+// Reads a response line from Grbl, waiting up to the given time in seconds. Returns the line
+// without its line ending, or NULL, if none was received in time.
+static char *stream_read_line(double timeout)
+{
+  double end = stream_time()+timeout;
+  for (;;) {
+    char c;
+    ssize_t count = read(stream_fd, &c, 1);
+    if (count == 1) {
+      if (c == '\n') {
+        stream_rx_line[stream_rx_length] = 0;
+        stream_rx_length = 0;
+        return(stream_rx_line);
+      }
+      if ((c != '\r') && (stream_rx_length < STREAM_LINE_SIZE-1)) { stream_rx_line[stream_rx_length++] = c; }
+      continue;
+    }
+    if ((count < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+      perror("grbl_stream: read");
+      exit(EXIT_FAILURE);
+    }
+    double remaining = end-stream_time();
+    if (remaining <= 0.0) { return(NULL); }
+    struct pollfd pfd = { stream_fd, POLLIN, 0 };
+    poll(&pfd, 1, (int)(remaining*1000)+1);
+  }
+}
+
+
+// Returns the status of a line response, 0 for 'ok' and the error code for 'error:N', or -1, if
+// the line is not a response to a streamed line.
+static int stream_response_status(const char *line)
+{
+  if (strcmp(line, "ok") == 0) { return(0); }
+  if (strncmp(line, "error:", 6) == 0) { return(atoi(line+6)); }
+  return(-1);
+}
+
+
+// Sends a command line and waits for its response. Returns its status. Reads the RX buffer size
+// from the last field of the '$I' build option line into rx_buffer_size, if given.
+static int stream_command(const char *command, uint16_t *rx_buffer_size)
+{
+  stream_write(command, strlen(command));
+  stream_write("\n", 1);
+  for (;;) {
+    char *line = stream_read_line(10.0);
+    if (line == NULL) {
+      fprintf(stderr, "grbl_stream: no response to '%s'\n", command);
+      exit(EXIT_FAILURE);
+    }
+    int status = stream_response_status(line);
+    if (status >= 0) { return(status); }
+    if ((rx_buffer_size != NULL) && (strncmp(line, "[OPT:", 5) == 0)) {
+      char *field = strrchr(line, ',');
+      if (field != NULL) { *rx_buffer_size = atoi(field+1); }
+    }
+    if (stream_verbose) { printf("%s\n", line); }
+  }
+}
+
+
+// Opens the serial device or pseudo-terminal at the given baud rate, raw and non-blocking.
+static void stream_open(const char *path, uint32_t baud_rate)
+{
+  stream_fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (stream_fd < 0) { perror(path); exit(EXIT_FAILURE); }
+  struct termios tio;
+  if (tcgetattr(stream_fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    speed_t speed;
+    switch (baud_rate) {
+      case 9600: speed = B9600; break;
+      case 19200: speed = B19200; break;
+      case 38400: speed = B38400; break;
+      case 57600: speed = B57600; break;
+      case 115200: speed = B115200; break;
+      case 230400: speed = B230400; break;
+      default: fprintf(stderr, "grbl_stream: unsupported baud rate %u\n", baud_rate); exit(EXIT_FAILURE);
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= (CLOCAL | CREAD);
+    tcsetattr(stream_fd, TCSANOW, &tio);
+  }
+}
+
+
+// Reads the g-code file. Spaces and comments are removed, and letters are upper cased, as by
+// stream.py. Returns the number of non-empty lines.
+static uint32_t stream_read_file(const char *path, char ***lines, stream_line_t **stats)
+{
+  FILE *file = fopen(path, "r");
+  if (file == NULL) { perror(path); exit(EXIT_FAILURE); }
+  char text[STREAM_LINE_SIZE];
+  uint32_t count = 0, size = 0, file_line = 0;
+  while (fgets(text, sizeof(text), file)) {
+    file_line++;
+    char line[STREAM_LINE_SIZE];
+    uint16_t length = 0;
+    char *c;
+    for (c = text; *c && (*c != ';'); c++) {
+      if (*c == '(') {
+        while (*c && (*c != ')')) { c++; }
+        if (!*c) { break; }
+      } else if (*c > ' ') {
+        line[length++] = ((*c >= 'a') && (*c <= 'z')) ? *c-'a'+'A' : *c;
+      }
+    }
+    line[length] = 0;
+    if (length == 0) { continue; }
+    if (count == size) {
+      size = (size ? 2*size : 1024);
+      *lines = realloc(*lines, size*sizeof(char *));
+      *stats = realloc(*stats, size*sizeof(stream_line_t));
+      if ((*lines == NULL) || (*stats == NULL)) { perror("grbl_stream"); exit(EXIT_FAILURE); }
+    }
+    (*lines)[count] = strdup(line);
+    memset(&(*stats)[count], 0, sizeof(stream_line_t));
+    (*stats)[count].length = length+1;
+    (*stats)[count].file_line = file_line;
+    count++;
+  }
+  fclose(file);
+  return(count);
+}
+
+
+static int stream_compare_double(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return((x > y) - (x < y));
+}
+
+
+static void stream_usage(const char *name)
+{
+  fprintf(stderr,
+    "Usage: %s [options] device file.nc\n"
+    "  Streams a g-code file to Grbl with the character-counting protocol and prints the throughput.\n"
+    "  The device is a serial port, or the pseudo-terminal link of grbl_sim.\n"
+    "  -b baud      Serial baud rate (default: 115200)\n"
+    "  -c           Stream in check mode\n"
+    "  -i seconds   Status report query interval (default: 1.0, 0 disables)\n"
+    "  -l file      Write the latency of each line to this CSV file\n"
+    "  -r line:cmd  Send a realtime command after sending the given line. The command is a character\n"
+    "               or a hex code, e.g. 20:! or 50:0x91. Repeatable\n"
+    "  -v           Print the messages of Grbl\n"
+    "  -w seconds   Wait for Grbl to start up after opening the device (default: 2.0)\n"
+    "  -x size      Grbl serial RX buffer size (default: read from '$I', or %u)\n",
+    name, STREAM_RX_BUFFER_SIZE);
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char *argv[])
+{
+  uint32_t baud_rate = 115200;
+  bool check_mode = false;
+  double report_interval = 1.0;
+  double startup_wait = 2.0;
+  uint16_t rx_buffer_size = 0;
+  FILE *log = NULL;
+  stream_realtime_t realtime[STREAM_MAX_REALTIME];
+  uint8_t realtime_count = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "b:ci:l:r:vw:x:")) != -1) {
+    switch (opt) {
+      case 'b': baud_rate = strtoul(optarg, NULL, 10); break;
+      case 'c': check_mode = true; break;
+      case 'i': report_interval = strtod(optarg, NULL); break;
+      case 'l':
+        log = fopen(optarg, "w");
+        if (log == NULL) { perror(optarg); return(EXIT_FAILURE); }
+        break;
+      case 'r': {
+        char *command = strchr(optarg, ':');
+        if ((command == NULL) || (command[1] == 0) || (realtime_count == STREAM_MAX_REALTIME)) { stream_usage(argv[0]); }
+        command++;
+        realtime[realtime_count].line = strtoul(optarg, NULL, 10);
+        realtime[realtime_count].command = (strlen(command) > 1) ? strtoul(command, NULL, 0) : command[0];
+        realtime_count++;
+        break;
+      }
+      case 'v': stream_verbose = true; break;
+      case 'w': startup_wait = strtod(optarg, NULL); break;
+      case 'x': rx_buffer_size = strtoul(optarg, NULL, 10); break;
+      default: stream_usage(argv[0]);
+    }
+  }
+  if (optind != argc-2) { stream_usage(argv[0]); }
+
+  char **lines = NULL;
+  stream_line_t *stats = NULL;
+  uint32_t line_count = stream_read_file(argv[optind+1], &lines, &stats);
+
+  // Wake up Grbl, which resets when a serial device is opened, and discard its start-up messages.
+  stream_open(argv[optind], baud_rate);
+  stream_write("\r\n\r\n", 4);
+  while (stream_read_line(startup_wait) != NULL) {}
+
+  uint16_t reported_size = STREAM_RX_BUFFER_SIZE;
+  stream_command("$I", &reported_size);
+  if (rx_buffer_size == 0) { rx_buffer_size = reported_size; }
+  if (check_mode && (stream_command("$C", NULL) != 0)) {
+    fprintf(stderr, "grbl_stream: check mode failed\n");
+    return(EXIT_FAILURE);
+  }
+  fprintf(stderr, "grbl_stream: streaming %u lines, with an RX buffer of %u characters\n",
+          line_count, rx_buffer_size);
+
+  // Stream with character counting. The pending lines are sent, but not yet answered.
+  uint32_t next_line = 0, next_response = 0;
+  uint16_t pending_chars = 0;
+  uint32_t errors = 0;
+  double start = stream_time();
+  double next_report = start+report_interval;
+  while (next_response < line_count) {
+    // Send as many lines as fit into the free RX buffer, each followed by its realtime commands.
+    while ((next_line < line_count) && (pending_chars+stats[next_line].length <= rx_buffer_size)) {
+      if (stats[next_line].length > rx_buffer_size) {
+        fprintf(stderr, "grbl_stream: line %u is longer than the RX buffer\n", stats[next_line].file_line);
+        return(EXIT_FAILURE);
+      }
+      stream_write(lines[next_line], stats[next_line].length-1);
+      stream_write("\n", 1);
+      stats[next_line].sent = stream_time();
+      pending_chars += stats[next_line].length;
+      next_line++;
+      uint8_t idx;
+      for (idx = 0; idx < realtime_count; idx++) {
+        if (realtime[idx].line == next_line) { stream_write((char *)&realtime[idx].command, 1); }
+      }
+    }
+    if ((next_line < line_count) && (pending_chars == 0)) {
+      fprintf(stderr, "grbl_stream: line %u is longer than the RX buffer\n", stats[next_line].file_line);
+      return(EXIT_FAILURE);
+    }
+
+    // Wait for a response, or the next status query.
+    double now = stream_time();
+    if ((report_interval > 0.0) && (now >= next_report)) {
+      stream_write("?", 1);
+      next_report += report_interval;
+      if (next_report < now) { next_report = now+report_interval; }
+    }
+    double timeout = (report_interval > 0.0) ? next_report-now : 1.0;
+    char *response = stream_read_line((timeout > 0.0) ? timeout : 0.0);
+    if (response == NULL) { continue; }
+    int status = stream_response_status(response);
+    if (status < 0) {
+      if (stream_verbose) { printf("%s\n", response); }
+      continue;
+    }
+    if (next_response == next_line) {
+      fprintf(stderr, "grbl_stream: unexpected response '%s'\n", response);
+      continue;
+    }
+    stream_line_t *line = &stats[next_response++];
+    line->latency = stream_time()-line->sent;
+    line->status = status;
+    pending_chars -= line->length;
+    if (status) {
+      fprintf(stderr, "grbl_stream: line %u: error:%u\n", line->file_line, status);
+      errors++;
+    }
+  }
+  double elapsed = stream_time()-start;
+  if (check_mode) { stream_command("$C", NULL); }
+
+  // Report the throughput and the latency statistics.
+  double *latency = malloc((line_count ? line_count : 1)*sizeof(double));
+  double sum = 0.0;
+  uint32_t idx;
+  if (log != NULL) { fprintf(log, "line,characters,latency,status\n"); }
+  for (idx = 0; idx < line_count; idx++) {
+    latency[idx] = stats[idx].latency;
+    sum += latency[idx];
+    if (log != NULL) {
+      fprintf(log, "%u,%u,%.6f,%u\n", stats[idx].file_line, stats[idx].length, stats[idx].latency, stats[idx].status);
+    }
+  }
+  if (log != NULL) { fclose(log); }
+  qsort(latency, line_count, sizeof(double), stream_compare_double);
+  printf("lines,errors,seconds,lines_per_sec,latency_mean_ms,latency_median_ms,latency_p99_ms,latency_max_ms\n");
+  if (line_count) {
+    printf("%u,%u,%.3f,%.1f,%.3f,%.3f,%.3f,%.3f\n", line_count, errors, elapsed, line_count/elapsed,
+           1000*sum/line_count, 1000*latency[line_count/2], 1000*latency[(uint32_t)(0.99*(line_count-1))],
+           1000*latency[line_count-1]);
+  }
+  return(errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}